@@ -0,0 +1,173 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "cacheModel.h"
+#include <algorithm>
+#include <cstdlib>
+
+static bool isPowerOfTwo(uint64_t x) {
+    return x != 0 && (x & (x - 1)) == 0;
+}
+
+// splits spec on ':' into fields
+static vector<string> splitFields(const string& spec) {
+    vector<string> fields;
+    size_t pos = 0;
+    while (true) {
+        const size_t colon = spec.find(':', pos);
+        fields.push_back(spec.substr(pos, colon == string::npos ? string::npos : colon - pos));
+        if (colon == string::npos) break;
+        pos = colon + 1;
+    }
+    return fields;
+}
+
+// digits with an optional K / M suffix
+static bool parseSize(string field, uint64_t& bytes) {
+    uint64_t scale = 1;
+    if (!field.empty() && (field.back() == 'K' || field.back() == 'k')) {
+        scale = 1024;
+        field.pop_back();
+    } else if (!field.empty() && (field.back() == 'M' || field.back() == 'm')) {
+        scale = 1024 * 1024;
+        field.pop_back();
+    }
+    if (field.empty() || field.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    bytes = (uint64_t)atoll(field.c_str()) * scale;
+    return bytes > 0;
+}
+
+bool parseCacheSpec(const string& spec, CacheLevelConfig& config) {
+    const vector<string> fields = splitFields(spec);
+    if (fields.size() < 3 || fields.size() > 4) {
+        return false;
+    }
+
+    uint64_t ways = 0;
+    uint64_t lineBytes = 0;
+    if (!parseSize(fields[0], config.sizeBytes) ||
+        fields[1].empty() || fields[1].find_first_not_of("0123456789") != string::npos ||
+        fields[2].empty() || fields[2].find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    ways = (uint64_t)atoll(fields[1].c_str());
+    lineBytes = (uint64_t)atoll(fields[2].c_str());
+
+    config.replacement = CacheReplacement::LRU;
+    if (fields.size() == 4) {
+        if (fields[3] == "lru") {
+            config.replacement = CacheReplacement::LRU;
+        } else if (fields[3] == "fifo") {
+            config.replacement = CacheReplacement::FIFO;
+        } else if (fields[3] == "random") {
+            config.replacement = CacheReplacement::Random;
+        } else {
+            return false;
+        }
+    }
+
+    if (ways == 0 || ways > 64 || !isPowerOfTwo(lineBytes) || config.sizeBytes % (ways * lineBytes) != 0) {
+        return false;
+    }
+    config.ways = (unsigned)ways;
+    config.lineBytes = (unsigned)lineBytes;
+    return isPowerOfTwo(config.sizeBytes / (ways * lineBytes));
+}
+
+void CacheLevel::init(const CacheLevelConfig& config) {
+    const uint64_t sets = config.sizeBytes / ((uint64_t)config.ways * config.lineBytes);
+    ways = config.ways;
+    lineShift = (unsigned)__builtin_ctzll(config.lineBytes);
+    setMask = sets - 1;
+    replacement = config.replacement;
+    tags.assign((size_t)(sets * ways), EMPTY);
+    hits = 0;
+    misses = 0;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Hit: LRU moves the line to the front of its set; FIFO and Random leave
+  the order alone.
+  Miss: while the set has an empty slot, or under LRU / FIFO, the ways shift
+  down one (the last line falls out) and the new line goes in front. A full
+  set under Random overwrites a random way instead.
+───────────────────────────────────────────────────────────────────────────────*/
+bool CacheLevel::access(uint64_t paddr) {
+    const uint64_t line = paddr >> lineShift;
+    uint64_t* set = &tags[(size_t)(line & setMask) * ways];
+
+    for (unsigned way = 0; way < ways; way++) {
+        if (set[way] == line) {
+            hits++;
+            if (replacement == CacheReplacement::LRU && way > 0) {
+                copy_backward(set, set + way, set + way + 1);
+                set[0] = line;
+            }
+            return true;
+        }
+        if (set[way] == EMPTY) break; // empty slots only follow the filled ones
+    }
+
+    misses++;
+    if (replacement == CacheReplacement::Random && set[ways - 1] != EMPTY) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        set[rng % ways] = line;
+    } else {
+        copy_backward(set, set + ways - 1, set + ways);
+        set[0] = line;
+    }
+    return false;
+}
+
+void CacheLevel::removeWay(uint64_t* set, unsigned way) {
+    copy(set + way + 1, set + ways, set + way);
+    set[ways - 1] = EMPTY;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Invalidation looks each line of the range up in its set, unless the range
+  has more lines than the cache has slots, in which case one sweep over the
+  tag array is cheaper.
+───────────────────────────────────────────────────────────────────────────────*/
+void CacheLevel::invalidate(uint64_t base, uint64_t bytes) {
+    const uint64_t first = base >> lineShift;
+    const uint64_t count = max<uint64_t>(bytes >> lineShift, 1);
+
+    if (count > tags.size()) {
+        for (size_t s = 0; s < tags.size(); s += ways) {
+            uint64_t* set = &tags[s];
+            for (unsigned way = 0; way < ways && set[way] != EMPTY;) {
+                if (set[way] - first < count) {
+                    removeWay(set, way);
+                } else {
+                    way++;
+                }
+            }
+        }
+        return;
+    }
+
+    for (uint64_t line = first; line < first + count; line++) {
+        uint64_t* set = &tags[(size_t)(line & setMask) * ways];
+        for (unsigned way = 0; way < ways && set[way] != EMPTY; way++) {
+            if (set[way] == line) {
+                removeWay(set, way);
+                break;
+            }
+        }
+    }
+}
+
+void CacheHierarchy::init(const vector<CacheLevelConfig>& configs) {
+    levels.resize(configs.size());
+    for (size_t i = 0; i < configs.size(); i++) {
+        levels[i].init(configs[i]);
+    }
+}
@@ -0,0 +1,419 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "checkpoint.h"
+#include "nfu.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Checkpoint file layout (native byte order, no padding):
+
+    header   : "PGCK" magic, format version
+    config   : address bits, level count, entries per level, backend,
+               reclaim flag, frame count, NFU interval, trace filter
+               (proc and reqtype tables, address window)
+    counters : SimCounters fields, trace file offset, table peak usage
+    nfu      : currentTime, timeSinceTick, loaded pages (with dirty flags
+               and owning process), accessed set
+    alloc    : frame allocation policy, then its per-process state and
+               clock hand when it is not the global pool
+    table    : radix - pre-order walk, only allocated arrays and valid
+                       mappings (with dirty bits) / present children
+                       are written
+               inverted - frame table and hash buckets as-is
+───────────────────────────────────────────────────────────────────────────────*/
+
+static const char     CHECKPOINT_MAGIC[4] = {'P', 'G', 'C', 'K'};
+static const uint32_t CHECKPOINT_VERSION  = 4;
+
+// Level flags written in front of every node of the radix tree
+static const uint8_t HAS_MAPPINGS = 0x1;
+static const uint8_t HAS_CHILDREN = 0x2;
+
+template <typename T>
+static void put(FILE* f, const T& value) {
+    fwrite(&value, sizeof(T), 1, f);
+}
+
+template <typename T>
+static bool get(FILE* f, T& value) {
+    return fread(&value, sizeof(T), 1, f) == 1;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Configuration block, written on save and compared on load.
+───────────────────────────────────────────────────────────────────────────────*/
+static void writeConfig(FILE* f, const PageTable& pt, const NFUState& nfuState, const TraceFilter& filter) {
+    put(f, (uint32_t)pt.addressBits);
+    put(f, (uint32_t)pt.numLevels);
+    for (int i = 0; i < pt.numLevels; i++) {
+        put(f, (uint32_t)pt.entryCount[i]);
+    }
+    put(f, (uint8_t)(pt.inverted != nullptr));
+    put(f, (uint8_t)pt.reclaimEmptyLevels);
+    put(f, (int32_t)nfuState.maxFrames);
+    put(f, (uint64_t)nfuState.interval);
+    // trace offsets count accepted records only, so they mean nothing under another filter
+    put(f, filter.procOk);
+    put(f, filter.typeOk);
+    put(f, filter.addrFirst);
+    put(f, filter.addrLast);
+}
+
+static bool configMatches(FILE* f, const PageTable& pt, const NFUState& nfuState, const TraceFilter& filter) {
+    uint32_t addressBits = 0, numLevels = 0;
+    if (!get(f, addressBits) || !get(f, numLevels)) return false;
+    if (addressBits != pt.addressBits || numLevels != (uint32_t)pt.numLevels) return false;
+
+    for (int i = 0; i < pt.numLevels; i++) {
+        uint32_t entries = 0;
+        if (!get(f, entries) || entries != pt.entryCount[i]) return false;
+    }
+
+    uint8_t inverted = 0, reclaim = 0;
+    int32_t maxFrames = 0;
+    uint64_t interval = 0;
+    if (!get(f, inverted) || !get(f, reclaim) || !get(f, maxFrames) || !get(f, interval)) return false;
+
+    uint8_t procOk[256], typeOk[256];
+    uint64_t addrFirst = 0, addrLast = 0;
+    if (!get(f, procOk) || !get(f, typeOk) || !get(f, addrFirst) || !get(f, addrLast)) return false;
+
+    return inverted == (pt.inverted != nullptr) &&
+           reclaim == pt.reclaimEmptyLevels &&
+           maxFrames == nfuState.maxFrames &&
+           interval == nfuState.interval &&
+           memcmp(procOk, filter.procOk, sizeof(procOk)) == 0 &&
+           memcmp(typeOk, filter.typeOk, sizeof(typeOk)) == 0 &&
+           addrFirst == filter.addrFirst && addrLast == filter.addrLast;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Radix tree: each node is its flags, then (leaf) the valid mappings as
+  (index, pfn, dirty) triples, or (interior) the present children as index + subtree.
+  Counts come from liveCount, which tracks exactly those entries.
+───────────────────────────────────────────────────────────────────────────────*/
+static void writeLevel(FILE* f, const Level* node) {
+    const uint8_t flags = (node->mappings ? HAS_MAPPINGS : 0) | (node->hasChildren() ? HAS_CHILDREN : 0);
+    put(f, flags);
+
+    if (node->mappings) {
+        put(f, (uint32_t)node->liveCount);
+        for (unsigned i = 0; i < node->entryCount; i++) {
+            if (node->mappings[i].valid) {
+                put(f, (uint32_t)i);
+                put(f, (int32_t)node->mappings[i].pfn);
+                put(f, (uint8_t)node->mappings[i].dirty);
+            }
+        }
+    }
+
+    if (node->hasChildren()) {
+        put(f, (uint32_t)node->liveCount);
+        node->forEachChild([&](unsigned i, const Level* child) {
+            put(f, (uint32_t)i);
+            writeLevel(f, child);
+        });
+    }
+}
+
+// rebuilds node through the normal allocation calls so TableStats stays correct
+static bool readLevel(FILE* f, const PageTable& pt, Level* node) {
+    uint8_t flags = 0;
+    if (!get(f, flags)) return false;
+    if ((flags & HAS_MAPPINGS) && !node->isLeaf) return false;
+    if ((flags & HAS_CHILDREN) && node->isLeaf) return false;
+
+    if (flags & HAS_MAPPINGS) {
+        node->allocateMappings();
+        uint32_t count = 0;
+        if (!get(f, count)) return false;
+        for (uint32_t n = 0; n < count; n++) {
+            uint32_t index = 0;
+            int32_t pfn = 0;
+            uint8_t dirty = 0;
+            if (!get(f, index) || !get(f, pfn) || !get(f, dirty) || index >= node->entryCount) return false;
+            Map* mapping = node->getMapping(index);
+            mapping->pfn = pfn;
+            mapping->valid = true;
+            mapping->dirty = dirty != 0;
+            node->liveCount++;
+        }
+    }
+
+    if (flags & HAS_CHILDREN) {
+        node->allocateChildren();
+        uint32_t count = 0;
+        if (!get(f, count)) return false;
+        const unsigned childDepth = node->depth + 1;
+        for (uint32_t n = 0; n < count; n++) {
+            uint32_t index = 0;
+            if (!get(f, index) || index >= node->entryCount) return false;
+            Level* child = node->ensureChild(index, pt.entryCount[childDepth],
+                                             childDepth == (unsigned)(pt.numLevels - 1));
+            if (!readLevel(f, pt, child)) return false;
+        }
+    }
+    return true;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Inverted table: flat arrays, written and read back verbatim.
+───────────────────────────────────────────────────────────────────────────────*/
+static void writeInverted(FILE* f, const InvertedPageTable& ipt) {
+    put(f, (uint64_t)ipt.frames.size());
+    for (size_t pfn = 0; pfn < ipt.frames.size(); pfn++) {
+        put(f, (int32_t)ipt.frames[pfn].pfn);
+        put(f, (uint8_t)ipt.frames[pfn].valid);
+        put(f, (uint8_t)ipt.frames[pfn].dirty);
+        put(f, ipt.frameVpn[pfn]);
+    }
+    put(f, (uint32_t)ipt.bucketBits);
+    put(f, (uint64_t)ipt.used);
+    fwrite(ipt.buckets.data(), sizeof(int), ipt.buckets.size(), f);
+}
+
+static bool readInverted(FILE* f, InvertedPageTable& ipt) {
+    uint64_t frameCount = 0;
+    if (!get(f, frameCount)) return false;
+
+    ipt.frames.resize(frameCount);
+    ipt.frameVpn.resize(frameCount);
+    for (size_t pfn = 0; pfn < frameCount; pfn++) {
+        int32_t framePfn = 0;
+        uint8_t valid = 0, dirty = 0;
+        if (!get(f, framePfn) || !get(f, valid) || !get(f, dirty) || !get(f, ipt.frameVpn[pfn])) return false;
+        ipt.frames[pfn].pfn = framePfn;
+        ipt.frames[pfn].valid = valid != 0;
+        ipt.frames[pfn].dirty = dirty != 0;
+    }
+
+    uint32_t bucketBits = 0;
+    uint64_t used = 0;
+    if (!get(f, bucketBits) || !get(f, used) || bucketBits > ipt.maxBucketBits) return false;
+    ipt.bucketBits = bucketBits;
+    ipt.used = used;
+    ipt.buckets.resize((size_t)1 << bucketBits);
+    if (fread(ipt.buckets.data(), sizeof(int), ipt.buckets.size(), f) != ipt.buckets.size()) return false;
+
+    ipt.syncStats();
+    return true;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  NFU state: vpnToIndex is rebuilt from the pages rather than stored.
+───────────────────────────────────────────────────────────────────────────────*/
+static void writeNFU(FILE* f, const NFUState& nfuState) {
+    put(f, nfuState.currentTime);
+    put(f, nfuState.timeSinceTick);
+
+    put(f, (uint64_t)nfuState.pages.size());
+    for (const LoadedPage& page : nfuState.pages) {
+        put(f, (int32_t)page.pfn);
+        put(f, page.vpn);
+        put(f, page.bitstring);
+        put(f, page.lastAccessTime);
+        put(f, (uint8_t)page.dirty);
+        put(f, page.proc);
+    }
+
+    put(f, (uint64_t)nfuState.accessed.size());
+    for (uint64_t vpn : nfuState.accessed) {
+        put(f, vpn);
+    }
+}
+
+static bool readNFU(FILE* f, NFUState& nfuState) {
+    if (!get(f, nfuState.currentTime) || !get(f, nfuState.timeSinceTick)) return false;
+
+    uint64_t pageCount = 0;
+    if (!get(f, pageCount) || pageCount > (uint64_t)nfuState.maxFrames) return false;
+    nfuState.pages.clear();
+    nfuState.vpnToIndex.clear();
+    for (uint64_t i = 0; i < pageCount; i++) {
+        LoadedPage page{};
+        int32_t pfn = 0;
+        uint8_t dirty = 0;
+        if (!get(f, pfn) || !get(f, page.vpn) || !get(f, page.bitstring) || !get(f, page.lastAccessTime) ||
+            !get(f, dirty) || !get(f, page.proc)) {
+            return false;
+        }
+        page.pfn = pfn;
+        page.dirty = dirty != 0;
+        nfuState.pages.push_back(page);
+        nfuState.vpnToIndex[page.vpn] = i;
+    }
+
+    uint64_t accessedCount = 0;
+    if (!get(f, accessedCount)) return false;
+    nfuState.accessed.clear();
+    for (uint64_t i = 0; i < accessedCount; i++) {
+        uint64_t vpn = 0;
+        if (!get(f, vpn)) return false;
+        nfuState.accessed.insert(vpn);
+    }
+    return true;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Frame allocator: its state only means something under the same policy,
+  so a restore under another one rebuilds it from the loaded pages.
+───────────────────────────────────────────────────────────────────────────────*/
+static void writeAllocator(FILE* f, const FrameAllocator& allocator) {
+    put(f, (uint8_t)allocator.config.policy);
+    if (!allocator.enabled()) return;
+
+    for (const ProcessFrames& p : allocator.procs) {
+        put(f, (uint8_t)p.seen);
+        put(f, p.accesses);
+        put(f, p.faults);
+        put(f, p.lastFault);
+        put(f, (int32_t)p.quota);
+        put(f, (int32_t)p.peakResident);
+    }
+    put(f, (int32_t)allocator.totalQuota);
+    put(f, allocator.quotaChanges);
+    put(f, (uint64_t)allocator.hand);
+}
+
+static bool readAllocator(FILE* f, FrameAllocator& allocator, const NFUState& nfuState) {
+    uint8_t policy = 0;
+    if (!get(f, policy)) return false;
+
+    FrameAllocator saved;
+    saved.init(allocator.config, allocator.totalFrames);
+    if (policy != (uint8_t)AllocPolicy::Global) {
+        for (ProcessFrames& p : saved.procs) {
+            uint8_t seen = 0;
+            int32_t quota = 0, peak = 0;
+            if (!get(f, seen) || !get(f, p.accesses) || !get(f, p.faults) || !get(f, p.lastFault) ||
+                !get(f, quota) || !get(f, peak)) {
+                return false;
+            }
+            p.seen = seen != 0;
+            p.quota = quota;
+            p.peakResident = peak;
+        }
+        int32_t totalQuota = 0;
+        uint64_t hand = 0;
+        if (!get(f, totalQuota) || !get(f, saved.quotaChanges) || !get(f, hand)) return false;
+        saved.totalQuota = totalQuota;
+        saved.hand = (size_t)hand;
+    }
+
+    if (!allocator.enabled()) return true;
+    allocator.resync(nfuState);
+    if (policy != (uint8_t)allocator.config.policy) return true;
+
+    // same policy: take the saved state, keeping the residency counted from the pages
+    for (int proc = 0; proc < FrameAllocator::MAX_PROCS; proc++) {
+        ProcessFrames& p = allocator.procs[proc];
+        const int resident = p.resident;
+        p = saved.procs[proc];
+        p.resident = resident;
+    }
+    allocator.totalQuota = saved.totalQuota;
+    allocator.quotaChanges = saved.quotaChanges;
+    allocator.hand = nfuState.pages.empty() ? 0 : saved.hand % nfuState.pages.size();
+    return true;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Public entry points.
+───────────────────────────────────────────────────────────────────────────────*/
+bool saveCheckpoint(const string& path, const Simulator& simulator, const TraceFilter& filter, uint64_t traceOffset) {
+    const PageTable& pt = simulator.pt;
+    const SimCounters& sim = simulator.counters;
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        cerr << "Unable to write checkpoint " << path << endl;
+        return false;
+    }
+
+    fwrite(CHECKPOINT_MAGIC, 1, sizeof(CHECKPOINT_MAGIC), f);
+    put(f, CHECKPOINT_VERSION);
+    writeConfig(f, pt, simulator.nfu, filter);
+
+    put(f, sim.count);
+    put(f, (int32_t)sim.nextFreePFN);
+    put(f, sim.hits);
+    put(f, sim.pageReplacements);
+    put(f, sim.framesAllocated);
+    put(f, sim.writeBacks);
+    put(f, traceOffset);
+    put(f, pt.stats.peakEntries);
+    put(f, pt.stats.peakBytes);
+
+    writeNFU(f, simulator.nfu);
+    writeAllocator(f, simulator.allocator);
+    if (pt.inverted) {
+        writeInverted(f, *pt.inverted);
+    } else {
+        writeLevel(f, pt.rootLevel);
+    }
+
+    const bool ok = !ferror(f);
+    if (fclose(f) != 0 || !ok) {
+        cerr << "Unable to write checkpoint " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+bool loadCheckpoint(const string& path, Simulator& simulator, const TraceFilter& filter, uint64_t& traceOffset) {
+    PageTable& pt = simulator.pt;
+    SimCounters& sim = simulator.counters;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+        cerr << "Unable to open checkpoint " << path << endl;
+        return false;
+    }
+
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    uint32_t version = 0;
+    if (fread(magic, 1, sizeof(magic), f) != sizeof(magic) ||
+        memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 ||
+        !get(f, version) || version != CHECKPOINT_VERSION) {
+        cerr << path << " is not a checkpoint file" << endl;
+        fclose(f);
+        return false;
+    }
+
+    if (!configMatches(f, pt, simulator.nfu, filter)) {
+        cerr << "Checkpoint " << path << " was taken with a different configuration" << endl;
+        fclose(f);
+        return false;
+    }
+
+    int32_t nextFreePFN = 0;
+    uint64_t peakEntries = 0, peakBytes = 0;
+    bool ok = get(f, sim.count) && get(f, nextFreePFN) && get(f, sim.hits) &&
+              get(f, sim.pageReplacements) && get(f, sim.framesAllocated) && get(f, sim.writeBacks) &&
+              get(f, traceOffset) && get(f, peakEntries) && get(f, peakBytes);
+    sim.nextFreePFN = nextFreePFN;
+    sim.run = RunCache{}; // the restored table has no previous access to repeat
+
+    ok = ok && readNFU(f, simulator.nfu);
+    ok = ok && readAllocator(f, simulator.allocator, simulator.nfu);
+    if (pt.inverted) {
+        ok = ok && readInverted(f, *pt.inverted);
+    } else {
+        ok = ok && readLevel(f, pt, pt.rootLevel);
+    }
+    fclose(f);
+
+    if (!ok) {
+        cerr << "Checkpoint " << path << " is truncated or corrupt" << endl;
+        return false;
+    }
+
+    // rebuilding only reaches the saved sizes, the peaks come from the file
+    if (peakEntries > pt.stats.peakEntries) pt.stats.peakEntries = peakEntries;
+    if (peakBytes > pt.stats.peakBytes) pt.stats.peakBytes = peakBytes;
+    return true;
+}
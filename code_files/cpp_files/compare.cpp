@@ -0,0 +1,159 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "compare.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+// Accesses read and decomposed per lockstep step
+static const size_t COMPARE_BATCH_SIZE = 256;
+
+// parses a positive int setting value, as the matching command line flag would
+static bool parsePositive(const string& value, int& out) {
+    if (value.empty() || value.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    out = atoi(value.c_str());
+    return out > 0;
+}
+
+bool parseCompareSpec(const string& spec, SimulatorConfig& config) {
+    size_t pos = 0;
+    while (pos < spec.size()) {
+        const size_t comma = spec.find(',', pos);
+        const string field = spec.substr(pos, comma == string::npos ? string::npos : comma - pos);
+        pos = (comma == string::npos) ? spec.size() : comma + 1;
+
+        const size_t eq = field.find('=');
+        const string key = field.substr(0, eq);
+        const string value = eq == string::npos ? "" : field.substr(eq + 1);
+
+        if (key == "f" && eq != string::npos) {
+            if (!parsePositive(value, config.frames)) return false;
+        } else if (key == "b" && eq != string::npos) {
+            if (!parsePositive(value, config.bitUpdateInterval)) return false;
+        } else if (key == "t" && (value == "radix" || value == "inverted")) {
+            config.inverted = (value == "inverted");
+        } else if (key == "r" && eq == string::npos) {
+            config.reclaimLevels = true;
+        } else if (key == "c" && eq != string::npos) {
+            // clean-first tolerance, 0 allowed
+            if (value.empty() || value.size() > 5 || value.find_first_not_of("0123456789") != string::npos) return false;
+            config.cleanTolerance = atoi(value.c_str());
+            if (config.cleanTolerance > 0xFFFF) return false;
+        } else if (key == "a" && eq != string::npos) {
+            if (!parseAllocSpec(value, config.alloc)) return false;
+        } else if (key == "s" && eq != string::npos) {
+            if (!parsePositive(value, config.sparseFill) || config.sparseFill > 100) return false;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// One simulator of the comparison and how often it disagreed with the others
+struct CompareInstance {
+    string spec; // --compare spec it was built from
+    unique_ptr<Simulator> sim;
+    uint64_t divergences = 0; // accesses where some other instance had a different outcome
+    int64_t firstDivergence = -1; // access number of the first of them, -1 if none
+};
+
+// Same outcome: both hit, both took a free frame, or both evicted the same page
+static bool sameOutcome(const AccessOutcome& a, const AccessOutcome& b) {
+    return a.pthit == b.pthit && a.vpnReplaced == b.vpnReplaced;
+}
+
+static void printOutcome(const AccessOutcome& out) {
+    if (out.pthit) {
+        printf(",hit");
+    } else if (out.vpnReplaced == -1) {
+        printf(",miss");
+    } else {
+        printf(",evict:%08" PRIX64, (uint64_t)out.vpnReplaced);
+    }
+}
+
+int runCompare(const vector<string>& traceFiles, const SimulatorConfig& base, const vector<string>& specs,
+               int64_t numAccesses, const TraceFilter& filter) {
+    vector<CompareInstance> instances(specs.size());
+    for (size_t k = 0; k < specs.size(); k++) {
+        SimulatorConfig config = base;
+        parseCompareSpec(specs[k], config);
+        instances[k].spec = specs[k];
+        instances[k].sim.reset(new Simulator);
+        instances[k].sim->init(config);
+    }
+
+    // every instance splits addresses the same way, so any one of them can decode
+    const PageTable& pt = instances[0].sim->pt;
+    TraceSource source;
+    if (!source.open(traceFiles, pt, filter)) {
+        return 1;
+    }
+
+    AddressBatch batch;
+    batch.init(pt.numLevels, COMPARE_BATCH_SIZE);
+    vector<AccessOutcome> outcomes(instances.size() * COMPARE_BATCH_SIZE); // [instance][access]
+    int64_t count = 0;
+
+    printf("access,vpn");
+    for (size_t k = 0; k < instances.size(); k++) {
+        printf(",config%zu", k);
+    }
+    printf("\n");
+
+    while (readAddressBatch(source, pt, batch, numAccesses > 0 ? numAccesses - count : -1)) {
+        // each instance runs the whole batch in turn, keeping its own state hot
+        for (size_t k = 0; k < instances.size(); k++) {
+            Simulator& sim = *instances[k].sim;
+            AccessOutcome* out = &outcomes[k * COMPARE_BATCH_SIZE];
+            for (size_t i = 0; i < batch.count; i++) {
+                out[i] = sim.access(batch, i);
+            }
+        }
+
+        for (size_t i = 0; i < batch.count; i++) {
+            const int64_t access = count + (int64_t)i + 1;
+            bool agree = true;
+            for (size_t k = 1; k < instances.size() && agree; k++) {
+                agree = sameOutcome(outcomes[i], outcomes[k * COMPARE_BATCH_SIZE + i]);
+            }
+            if (agree) continue;
+
+            printf("%" PRId64 ",%08" PRIX64, access, batch.vaddr[i] >> pt.offsetBits);
+            for (size_t k = 0; k < instances.size(); k++) {
+                const AccessOutcome& mine = outcomes[k * COMPARE_BATCH_SIZE + i];
+                printOutcome(mine);
+
+                bool agreesWithAll = true;
+                for (size_t j = 0; j < instances.size() && agreesWithAll; j++) {
+                    agreesWithAll = sameOutcome(mine, outcomes[j * COMPARE_BATCH_SIZE + i]);
+                }
+                if (!agreesWithAll) {
+                    CompareInstance& inst = instances[k];
+                    if (inst.divergences++ == 0) inst.firstDivergence = access;
+                }
+            }
+            printf("\n");
+        }
+        count += (int64_t)batch.count;
+    }
+
+    printf("\nconfig,spec,accesses,hits,misses,replacements,diverging_accesses,first_divergence\n");
+    for (size_t k = 0; k < instances.size(); k++) {
+        const CompareInstance& inst = instances[k];
+        const SimulatorStats st = inst.sim->stats();
+        printf("%zu,\"%s\",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRId64 "\n",
+               k, inst.spec.c_str(), st.accesses, st.hits, st.misses, st.pageReplacements,
+               inst.divergences, inst.firstDivergence);
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "concurrentPageTable.h"
+
+ConcurrentLevel::ConcurrentLevel(unsigned entryCount_, unsigned depth_, bool isLeaf)
+    : entryCount(entryCount_), depth(depth_) {
+    if (isLeaf) {
+        entries = new atomic<uint64_t>[entryCount];
+        for (unsigned i = 0; i < entryCount; i++) {
+            entries[i].store(0, memory_order_relaxed);
+        }
+    } else {
+        children = new atomic<ConcurrentLevel*>[entryCount];
+        for (unsigned i = 0; i < entryCount; i++) {
+            children[i].store(nullptr, memory_order_relaxed);
+        }
+    }
+}
+
+// only runs once no other thread uses the table
+ConcurrentLevel::~ConcurrentLevel() {
+    if (children) {
+        for (unsigned i = 0; i < entryCount; i++) {
+            delete children[i].load(memory_order_relaxed);
+        }
+        delete[] children;
+    }
+    delete[] entries;
+}
+
+// bytes one level holds, node included
+static uint64_t levelBytes(unsigned entryCount, bool isLeaf) {
+    const uint64_t slot = isLeaf ? sizeof(atomic<uint64_t>) : sizeof(atomic<ConcurrentLevel*>);
+    return sizeof(ConcurrentLevel) + entryCount * slot;
+}
+
+void ConcurrentPageTable::init(const PageTable& layout) {
+    delete root;
+    numLevels  = layout.numLevels;
+    entryCount = layout.entryCount;
+    bitmasks   = layout.bitmasks;
+    shifts     = layout.shifts;
+    root = new ConcurrentLevel(entryCount[0], 0, numLevels == 1);
+    nodes.store(1, memory_order_relaxed);
+    bytes.store(levelBytes(entryCount[0], numLevels == 1), memory_order_relaxed);
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Child install: build the level, then publish it with one CAS. Release
+  on success makes its zeroed slots visible before the pointer; on failure
+  the acquire load hands back the winner's level, and ours never escaped.
+───────────────────────────────────────────────────────────────────────────────*/
+ConcurrentLevel* ConcurrentPageTable::ensureChild(ConcurrentLevel* node, unsigned index) {
+    atomic<ConcurrentLevel*>& slot = node->children[index];
+    ConcurrentLevel* child = slot.load(memory_order_acquire);
+    if (child) return child;
+
+    const unsigned depth = node->depth + 1;
+    const bool isLeaf = depth == (unsigned)(numLevels - 1);
+    ConcurrentLevel* fresh = new ConcurrentLevel(entryCount[depth], depth, isLeaf);
+    if (slot.compare_exchange_strong(child, fresh, memory_order_release, memory_order_acquire)) {
+        nodes.fetch_add(1, memory_order_relaxed);
+        bytes.fetch_add(levelBytes(entryCount[depth], isLeaf), memory_order_relaxed);
+        return fresh;
+    }
+    delete fresh;
+    return child; // the CAS loaded the level that won
+}
+
+bool ConcurrentPageTable::lookup(uint64_t vaddr, uint32_t& pfn) const {
+    const ConcurrentLevel* node = root;
+    for (int level = 0; level < numLevels - 1; level++) {
+        const unsigned piece = (unsigned)((vaddr & bitmasks[level]) >> shifts[level]);
+        node = node->children[piece].load(memory_order_acquire);
+        if (!node) return false;
+    }
+
+    const unsigned piece = (unsigned)((vaddr & bitmasks[numLevels - 1]) >> shifts[numLevels - 1]);
+    const uint64_t entry = node->entries[piece].load(memory_order_acquire);
+    if (!(entry & VALID)) return false;
+    pfn = (uint32_t)(entry & PFN_MASK);
+    return true;
+}
+
+ConcurrentOutcome ConcurrentPageTable::translate(uint64_t vaddr, bool write, atomic<uint32_t>& nextFrame,
+                                                 uint32_t& pfn) {
+    ConcurrentLevel* node = root;
+    for (int level = 0; level < numLevels - 1; level++) {
+        const unsigned piece = (unsigned)((vaddr & bitmasks[level]) >> shifts[level]);
+        node = ensureChild(node, piece);
+    }
+
+    const unsigned piece = (unsigned)((vaddr & bitmasks[numLevels - 1]) >> shifts[numLevels - 1]);
+    atomic<uint64_t>& entry = node->entries[piece];
+    uint64_t current = entry.load(memory_order_acquire);
+
+    if (current & VALID) {
+        pfn = (uint32_t)(current & PFN_MASK);
+        if (write && !(current & DIRTY)) {
+            entry.fetch_or(DIRTY, memory_order_relaxed);
+        }
+        return ConcurrentOutcome::Hit;
+    }
+
+    const uint32_t frame = nextFrame.fetch_add(1, memory_order_relaxed);
+    const uint64_t mapped = VALID | (write ? DIRTY : 0) | frame;
+    if (entry.compare_exchange_strong(current, mapped, memory_order_acq_rel, memory_order_acquire)) {
+        pfn = frame;
+        return ConcurrentOutcome::Installed;
+    }
+
+    // current now holds the winner's entry
+    pfn = (uint32_t)(current & PFN_MASK);
+    if (write && !(current & DIRTY)) {
+        entry.fetch_or(DIRTY, memory_order_relaxed);
+    }
+    return ConcurrentOutcome::LostRace;
+}
+
+static uint64_t countMappedBelow(const ConcurrentLevel* node) {
+    uint64_t mapped = 0;
+    for (unsigned i = 0; i < node->entryCount; i++) {
+        if (node->entries) {
+            mapped += (node->entries[i].load(memory_order_relaxed) & ConcurrentPageTable::VALID) ? 1 : 0;
+        } else if (const ConcurrentLevel* child = node->children[i].load(memory_order_relaxed)) {
+            mapped += countMappedBelow(child);
+        }
+    }
+    return mapped;
+}
+
+uint64_t ConcurrentPageTable::countMapped() const {
+    return root ? countMappedBelow(root) : 0;
+}
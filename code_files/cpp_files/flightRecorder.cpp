@@ -0,0 +1,166 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "flightRecorder.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+volatile sig_atomic_t flightDumpRequested = 0;
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Dump file layout (little endian, as written by this machine):
+
+    "PGFR", version (u32), reason (u8), address bits (u32), level count (u32),
+    level bits (u32 each), access count (u64), events recorded (u64),
+    events stored (u64), then the stored FlightEvents, oldest first.
+───────────────────────────────────────────────────────────────────────────────*/
+static const char FLIGHT_MAGIC[4] = {'P', 'G', 'F', 'R'};
+static const uint32_t FLIGHT_VERSION = 1;
+
+template <typename T>
+static void put(FILE* f, const T& value) {
+    fwrite(&value, sizeof(T), 1, f);
+}
+
+template <typename T>
+static bool get(FILE* f, T& value) {
+    return fread(&value, sizeof(T), 1, f) == 1;
+}
+
+FlightRecorder::~FlightRecorder() {
+    if (dumpAtExit && enabled()) dump(FlightDumpReason::Exit);
+}
+
+void FlightRecorder::init(uint64_t events, const string& path_, const vector<int>& levelBits_, unsigned addressBits_) {
+    uint64_t size = 1;
+    while (size < events) size <<= 1;
+    ring.assign(size, FlightEvent{});
+    mask = size - 1;
+    head = 0;
+    path = path_;
+    levelBits = levelBits_;
+    addressBits = addressBits_;
+}
+
+void FlightRecorder::advanceTrigger(uint64_t count, uint64_t faults) {
+    windowAccesses += count;
+    windowFaults += faults;
+    if (windowFaults >= triggerFaults) {
+        triggered = true;
+        dump(FlightDumpReason::Trigger);
+    } else if (windowAccesses >= triggerWindow) {
+        windowAccesses = 0;
+        windowFaults = 0;
+    }
+}
+
+bool FlightRecorder::dump(FlightDumpReason reason) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        cerr << "Unable to open " << path << endl;
+        return false;
+    }
+
+    const uint64_t stored = head < ring.size() ? head : ring.size();
+    fwrite(FLIGHT_MAGIC, 1, sizeof(FLIGHT_MAGIC), f);
+    put(f, FLIGHT_VERSION);
+    put(f, (uint8_t)reason);
+    put(f, (uint32_t)addressBits);
+    put(f, (uint32_t)levelBits.size());
+    for (int bits : levelBits) put(f, (uint32_t)bits);
+    put(f, accessCount);
+    put(f, head);
+    put(f, stored);
+
+    // oldest first: the ring wraps at head once it is full
+    const uint64_t first = head - stored;
+    const uint64_t start = first & mask;
+    const uint64_t tail = min<uint64_t>(stored, ring.size() - start);
+    fwrite(&ring[start], sizeof(FlightEvent), tail, f);
+    fwrite(&ring[0], sizeof(FlightEvent), stored - tail, f);
+
+    const bool ok = !ferror(f);
+    fclose(f);
+    if (!ok) {
+        cerr << "Unable to write " << path << endl;
+        return false;
+    }
+    dumps++;
+    return true;
+}
+
+bool parseFlightTrigger(const string& spec, uint64_t& faults, uint64_t& window) {
+    const size_t colon = spec.find(':');
+    if (colon == string::npos) return false;
+    const string a = spec.substr(0, colon);
+    const string b = spec.substr(colon + 1);
+    for (const string& value : {a, b}) {
+        if (value.empty() || value.size() > 12 || value.find_first_not_of("0123456789") != string::npos) {
+            return false;
+        }
+    }
+    faults = (uint64_t)atoll(a.c_str());
+    window = (uint64_t)atoll(b.c_str());
+    return faults > 0 && faults <= window;
+}
+
+static void onFlightSignal(int) {
+    flightDumpRequested = 1;
+}
+
+void installFlightSignal() {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onFlightSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, nullptr);
+}
+
+bool readFlightDump(const string& path, FlightDump& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+        cerr << "Unable to open " << path << endl;
+        return false;
+    }
+
+    char magic[4] = {};
+    uint32_t version = 0, addressBits = 0, levels = 0;
+    uint8_t reason = 0;
+    uint64_t stored = 0;
+    bool ok = fread(magic, 1, sizeof(magic), f) == sizeof(magic) && memcmp(magic, FLIGHT_MAGIC, sizeof(magic)) == 0 &&
+              get(f, version) && version == FLIGHT_VERSION && get(f, reason) && get(f, addressBits) &&
+              get(f, levels) && levels > 0 && levels <= 64;
+    // the geometry goes straight into PageTable::initFromLevelBits: same limits as the command line
+    ok = ok && addressBits >= 32 && addressBits <= 64;
+    out.levelBits.clear();
+    uint32_t totalBits = 0;
+    for (uint32_t i = 0; ok && i < levels; i++) {
+        uint32_t bits = 0;
+        ok = get(f, bits) && bits >= 1 && bits <= 30;
+        totalBits += bits;
+        out.levelBits.push_back((int)bits);
+    }
+    ok = ok && totalBits <= addressBits - 4;
+    ok = ok && get(f, out.accessCount) && get(f, out.recorded) && get(f, stored) && stored <= out.recorded &&
+         stored <= ((uint64_t)1 << 32);
+    if (ok) {
+        out.events.resize(stored);
+        ok = fread(out.events.data(), sizeof(FlightEvent), stored, f) == stored;
+    }
+    fclose(f);
+
+    if (!ok) {
+        cerr << path << " is not a flight recorder dump" << endl;
+        return false;
+    }
+    out.reason = (FlightDumpReason)reason;
+    out.addressBits = addressBits;
+    return true;
+}
@@ -0,0 +1,214 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "frameAllocation.h"
+#include <cinttypes>
+#include <cstdlib>
+#include <iostream>
+
+// parses a non-negative count of at most 9 digits
+static bool parseCount(const string& value, uint64_t& out) {
+    if (value.empty() || value.size() > 9 || value.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    out = (uint64_t)atoll(value.c_str());
+    return true;
+}
+
+bool parseAllocSpec(const string& spec, AllocConfig& config) {
+    vector<string> fields;
+    size_t pos = 0;
+    while (true) {
+        const size_t colon = spec.find(':', pos);
+        fields.push_back(spec.substr(pos, colon == string::npos ? string::npos : colon - pos));
+        if (colon == string::npos) break;
+        pos = colon + 1;
+    }
+
+    uint64_t a = 0, b = 0;
+    if (fields[0] == "fixed" && fields.size() == 2 && parseCount(fields[1], a) && a > 0) {
+        config.policy = AllocPolicy::Fixed;
+        config.quota = (int)a;
+    } else if (fields[0] == "pff" && fields.size() == 3 && parseCount(fields[1], a) && parseCount(fields[2], b) &&
+               a <= b) {
+        config.policy = AllocPolicy::PFF;
+        config.low = a;
+        config.high = b;
+    } else if (fields[0] == "wsclock" && fields.size() == 2 && parseCount(fields[1], a) && a > 0) {
+        config.policy = AllocPolicy::WSClock;
+        config.tau = a;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* allocPolicyName(AllocPolicy policy) {
+    switch (policy) {
+        case AllocPolicy::Fixed:   return "fixed";
+        case AllocPolicy::PFF:     return "pff";
+        case AllocPolicy::WSClock: return "wsclock";
+        case AllocPolicy::Global:  break;
+    }
+    return "global";
+}
+
+void FrameAllocator::init(const AllocConfig& config_, int totalFrames_) {
+    closeLog();
+    config = config_;
+    procs.assign(MAX_PROCS, ProcessFrames{});
+    totalFrames = totalFrames_;
+    totalQuota = 0;
+    quotaChanges = 0;
+    hand = 0;
+}
+
+bool FrameAllocator::openLog(const string& path) {
+    log = fopen(path.c_str(), "w");
+    if (!log) {
+        cerr << "Unable to open " << path << endl;
+        return false;
+    }
+    fprintf(log, "access,proc,quota,resident,faults\n");
+    return true;
+}
+
+void FrameAllocator::closeLog() {
+    if (log) {
+        fclose(log);
+        log = nullptr;
+    }
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Quotas. Every setting is one row of the quota CSV:
+  access (virtual time), proc, quota, resident, faults so far.
+───────────────────────────────────────────────────────────────────────────────*/
+void FrameAllocator::firstAccess(uint8_t proc, uint64_t now) {
+    ProcessFrames& p = procs[proc];
+    p.seen = true;
+    if (config.policy == AllocPolicy::Fixed) {
+        setQuota(proc, config.quota, now);
+    } else if (config.policy == AllocPolicy::PFF) {
+        setQuota(proc, 1, now);
+    }
+}
+
+void FrameAllocator::setQuota(uint8_t proc, int quota, uint64_t now) {
+    ProcessFrames& p = procs[proc];
+    if (config.policy != AllocPolicy::WSClock) {
+        totalQuota += quota - p.quota;
+    }
+    if (p.faults > 0) {
+        quotaChanges++;
+    }
+    p.quota = quota;
+    if (log) {
+        fprintf(log, "%" PRIu64 ",%d,%d,%d,%" PRIu64 "\n", now, (int)proc, p.quota, p.resident, p.faults);
+    }
+}
+
+void FrameAllocator::onFault(uint8_t proc, uint64_t now) {
+    ProcessFrames& p = procs[proc];
+    p.faults++;
+    if (config.policy == AllocPolicy::PFF && p.faults > 1) {
+        const uint64_t gap = p.accesses - p.lastFault;
+        if (gap < config.low && totalQuota < totalFrames) {
+            setQuota(proc, p.quota + 1, now);
+        } else if (gap > config.high && p.quota > 1) {
+            setQuota(proc, p.quota - 1, now);
+        }
+    }
+    p.lastFault = p.accesses;
+}
+
+void FrameAllocator::moveFrame(int from, uint8_t to, uint64_t now) {
+    if (from == (int)to) return;
+    if (from >= 0) {
+        ProcessFrames& donor = procs[(size_t)from];
+        donor.resident--;
+        if (config.policy == AllocPolicy::WSClock) setQuota((uint8_t)from, donor.resident, now);
+    }
+    ProcessFrames& p = procs[to];
+    p.resident++;
+    if (p.resident > p.peakResident) p.peakResident = p.resident;
+    if (config.policy == AllocPolicy::WSClock) setQuota(to, p.resident, now);
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Victim selection, see the policy description in frameAllocation.h.
+───────────────────────────────────────────────────────────────────────────────*/
+int FrameAllocator::pickVictim(NFUState& nfu, uint8_t proc, vector<uint64_t>& cleaned) {
+    const bool freeFrame = !isFullNFU(nfu);
+    if (config.policy == AllocPolicy::WSClock) {
+        return freeFrame ? -1 : wsclockVictim(nfu, cleaned);
+    }
+
+    const ProcessFrames& p = procs[proc];
+    if (p.resident < p.quota) {
+        if (freeFrame) return -1;
+
+        int donor = -1;
+        int excess = 0;
+        for (int q = 0; q < MAX_PROCS; q++) {
+            if (procs[q].resident - procs[q].quota > excess) {
+                excess = procs[q].resident - procs[q].quota;
+                donor = q;
+            }
+        }
+        if (donor >= 0) return selectVictimNFU(nfu, donor);
+    }
+    if (p.resident > 0) return selectVictimNFU(nfu, proc);
+    return freeFrame ? -1 : selectVictimNFU(nfu);
+}
+
+int FrameAllocator::wsclockVictim(NFUState& nfu, vector<uint64_t>& cleaned) {
+    const size_t n = nfu.pages.size();
+    int firstCleaned = -1;
+
+    for (size_t step = 0; step < n; step++) {
+        LoadedPage& page = nfu.pages[hand];
+        const int index = (int)hand;
+        hand = (hand + 1) % n;
+
+        if (nfu.currentTime - page.lastAccessTime <= config.tau) {
+            continue; // in its working set
+        }
+        if (page.dirty) {
+            page.dirty = false;
+            cleaned.push_back(page.vpn);
+            if (firstCleaned < 0) firstCleaned = index;
+            continue;
+        }
+        return index;
+    }
+    if (firstCleaned >= 0) return firstCleaned;
+
+    // every page is in a working set: the one under the hand goes
+    const int index = (int)hand;
+    hand = (hand + 1) % n;
+    return index;
+}
+
+void FrameAllocator::resync(const NFUState& nfu) {
+    for (ProcessFrames& p : procs) {
+        p.resident = 0;
+    }
+    for (const LoadedPage& page : nfu.pages) {
+        procs[page.proc].resident++;
+    }
+
+    totalQuota = 0;
+    for (int proc = 0; proc < MAX_PROCS; proc++) {
+        ProcessFrames& p = procs[proc];
+        p.seen = p.resident > 0;
+        p.peakResident = p.resident;
+        // PFF restarts from what each process holds
+        p.quota = (config.policy == AllocPolicy::Fixed && p.seen) ? config.quota : p.resident;
+        if (config.policy != AllocPolicy::WSClock) totalQuota += p.quota;
+    }
+    hand = 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+/*
+ * frdecode: prints a flight recorder dump (pagingwithpr --flight-events)
+ *
+ *   frdecode [-l events|va2pa|vpns_pfn|vpn2pfn_pr] dump.pgfr
+ *
+ * events (the default) prints every event on a line of its own after a
+ * header saying why the dump was written. The other modes print the
+ * accesses in the dump the way pagingwithpr's -l mode of the same name
+ * does, so the tail of a long run can be diffed against a short one.
+ *
+ * A dump keeps the first access of each same-page run with its address and
+ * the rest as Repeat events holding only the page, so va2pa prints those
+ * with offset 0. A ring that wrapped can start between an Evict and the
+ * Miss it belongs to; that first Miss is then printed without its victim.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "flightRecorder.h"
+#include "pageTable.h"
+#include "log_helpers.h"
+
+using namespace std;
+
+static const char* eventName(FlightEventType type) {
+    switch (type) {
+        case FlightEventType::Hit:        return "hit";
+        case FlightEventType::Miss:       return "miss";
+        case FlightEventType::Evict:      return "evict";
+        case FlightEventType::Repeat:     return "repeat";
+        case FlightEventType::Tick:       return "tick";
+        case FlightEventType::Prefetch:   return "prefetch";
+        case FlightEventType::TableAlloc: return "table_alloc";
+        case FlightEventType::TableFree:  return "table_free";
+    }
+    return "unknown";
+}
+
+static const char* reasonName(FlightDumpReason reason) {
+    switch (reason) {
+        case FlightDumpReason::Exit:    return "exit";
+        case FlightDumpReason::Signal:  return "signal";
+        case FlightDumpReason::Trigger: return "trigger";
+    }
+    return "unknown";
+}
+
+static void printEvents(const FlightDump& dump) {
+    printf("reason %s, %" PRIu64 " accesses, %zu of %" PRIu64 " events\n", reasonName(dump.reason),
+           dump.accessCount, dump.events.size(), dump.recorded);
+
+    uint64_t index = dump.recorded - dump.events.size();
+    for (const FlightEvent& event : dump.events) {
+        printf("%10" PRIu64 " %-11s ", index++, eventName(event.type));
+        switch (event.type) {
+            case FlightEventType::Hit:
+            case FlightEventType::Miss:
+                printf("vaddr %08" PRIX64 " -> pfn %" PRIu32 " proc %u", event.addr, event.pfn, event.aux);
+                break;
+            case FlightEventType::Evict:
+                printf("vpn %" PRIX64 " pfn %" PRIu32 " bitstring %04X", event.addr, event.pfn, event.aux);
+                break;
+            case FlightEventType::Repeat:
+                printf("page %08" PRIX64 " -> pfn %" PRIu32 " x %u", event.addr, event.pfn, event.aux);
+                break;
+            case FlightEventType::Tick:
+                printf("time %" PRIu64 " ticks %" PRIu32, event.addr, event.pfn);
+                break;
+            case FlightEventType::Prefetch:
+                printf("vpn %" PRIX64 " -> pfn %" PRIu32, event.addr, event.pfn);
+                break;
+            case FlightEventType::TableAlloc:
+            case FlightEventType::TableFree:
+                printf("%" PRIu64 " bytes %" PRIu32 " entries", event.addr, event.pfn);
+                break;
+        }
+        if (event.flags & FLIGHT_WRITE) printf(" write");
+        if (event.flags & FLIGHT_DIRTY) printf(" dirty");
+        printf("\n");
+    }
+}
+
+// Prints the accesses of the dump in one of pagingwithpr's per-access log modes
+static void printAccesses(const FlightDump& dump, const string& mode) {
+    PageTable layout;
+    layout.initFromLevelBits(dump.levelBits, dump.addressBits);
+    vector<uint32_t> vpnPieces(layout.numLevels);
+
+    const FlightEvent* victim = nullptr; // Evict waiting for the Miss that took its frame
+
+    auto logAccess = [&](uint64_t vaddr, uint32_t pfn, bool pthit) {
+        if (mode == "va2pa") {
+            log_va2pa(vaddr, ((uint64_t)pfn << layout.offsetBits) | layout.getOffset(vaddr));
+        } else if (mode == "vpns_pfn") {
+            for (int level = 0; level < layout.numLevels; level++) {
+                vpnPieces[level] = layout.getVPNPiece(vaddr, level);
+            }
+            log_vpns_pfn(layout.numLevels, vpnPieces.data(), pfn);
+        } else if (victim && !pthit) {
+            log_mapping(vaddr >> layout.offsetBits, pfn, (int64_t)victim->addr, victim->aux, false);
+        } else {
+            log_mapping(vaddr >> layout.offsetBits, pfn, -1, 0, pthit);
+        }
+    };
+
+    for (const FlightEvent& event : dump.events) {
+        switch (event.type) {
+            case FlightEventType::Hit:
+            case FlightEventType::Miss:
+                logAccess(event.addr, event.pfn, event.type == FlightEventType::Hit);
+                victim = nullptr;
+                break;
+            case FlightEventType::Repeat:
+                for (unsigned k = 0; k < event.aux; k++) logAccess(event.addr, event.pfn, true);
+                break;
+            case FlightEventType::Evict:
+                victim = &event;
+                break;
+            case FlightEventType::Prefetch:
+                victim = nullptr; // that eviction made room for the prefetch
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    string mode = "events";
+    int option;
+    while ((option = getopt(argc, argv, "l:")) != -1) {
+        switch (option) {
+            case 'l':
+                mode = optarg;
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-l events|va2pa|vpns_pfn|vpn2pfn_pr] dump.pgfr" << endl;
+                return 1;
+        }
+    }
+    if (optind != argc - 1) {
+        cerr << "Usage: " << argv[0] << " [-l events|va2pa|vpns_pfn|vpn2pfn_pr] dump.pgfr" << endl;
+        return 1;
+    }
+    if (mode != "events" && mode != "va2pa" && mode != "vpns_pfn" && mode != "vpn2pfn_pr") {
+        cerr << "Unknown log mode " << mode << endl;
+        return 1;
+    }
+
+    FlightDump dump;
+    if (!readFlightDump(argv[optind], dump)) {
+        return 1;
+    }
+    if (mode == "events") {
+        printEvents(dump);
+    } else {
+        printAccesses(dump, mode);
+    }
+    return 0;
+}
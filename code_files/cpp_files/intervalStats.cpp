@@ -0,0 +1,62 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "intervalStats.h"
+#include <cinttypes>
+#include <iostream>
+
+bool IntervalRecorder::open(const RunOptions& opts, const SimCounters& sim) {
+    every = opts.intervalStats;
+    if (every == 0) {
+        return true;
+    }
+
+    out = opts.intervalFile.empty() ? stdout : fopen(opts.intervalFile.c_str(), "w");
+    if (!out) {
+        cerr << "Unable to open " << opts.intervalFile << endl;
+        every = 0;
+        return false;
+    }
+
+    windowStart = sim;
+    window = sim.count / every;
+    fprintf(out, "end_access,accesses,hits,hit_rate,faults,replacements,pt_entries,pt_bytes,working_set\n");
+    return true;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  One row. Faults are misses in the window (free-frame loads plus
+  replacements); entries and bytes are the table's size at the window's end.
+───────────────────────────────────────────────────────────────────────────────*/
+void IntervalRecorder::emit(const PageTable& pt, const SimCounters& sim) {
+    const uint64_t accesses     = (uint64_t)(sim.count - windowStart.count);
+    const uint64_t hits         = sim.hits - windowStart.hits;
+    const uint64_t replacements = sim.pageReplacements - windowStart.pageReplacements;
+
+    fprintf(out, "%" PRId64 ",%" PRIu64 ",%" PRIu64 ",%.6f,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+            sim.count, accesses, hits, (double)hits / (double)accesses, accesses - hits, replacements,
+            pt.stats.entries, pt.countBytes(), workingSet);
+
+    windowStart = sim;
+    window++;
+    workingSet = 0;
+    haveLast = false;
+}
+
+void IntervalRecorder::close(const PageTable& pt, const SimCounters& sim) {
+    if (every == 0) {
+        return;
+    }
+    if (sim.count > windowStart.count) {
+        emit(pt, sim);
+    }
+    if (out == stdout) {
+        fflush(out);
+    } else {
+        fclose(out);
+    }
+    every = 0;
+}
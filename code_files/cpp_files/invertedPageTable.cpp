@@ -0,0 +1,143 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "invertedPageTable.h"
+
+// smallest bucket array allocated up front, grown on demand up to maxBucketBits
+static const unsigned MIN_BUCKET_BITS = 10;
+
+// sizes the hash to keep load factor at or below 1/2 once every frame is used
+void InvertedPageTable::init(int maxFrames, unsigned offsetBits_) {
+    offsetBits = offsetBits_;
+
+    maxBucketBits = 1;
+    while ((1ull << maxBucketBits) < 2ull * (uint64_t)maxFrames) {
+        maxBucketBits++;
+    }
+    bucketBits = maxBucketBits < MIN_BUCKET_BITS ? maxBucketBits : MIN_BUCKET_BITS;
+
+    frames.clear();
+    frameVpn.clear();
+    buckets.assign((size_t)1 << bucketBits, -1);
+    used = 0;
+    syncStats();
+}
+
+void InvertedPageTable::syncStats() {
+    if (!stats) return;
+    stats->released(statsEntries, statsBytes);
+    statsEntries = countEntries();
+    statsBytes = countBytes();
+    stats->allocated(statsEntries, statsBytes);
+}
+
+long InvertedPageTable::findBucket(uint64_t vpn) const {
+    const size_t mask = buckets.size() - 1;
+    for (size_t slot = homeBucket(vpn); buckets[slot] != -1; slot = (slot + 1) & mask) {
+        if (frameVpn[buckets[slot]] == vpn) {
+            return (long)slot;
+        }
+    }
+    return -1;
+}
+
+// backward shift deletion: keeps probe runs intact without tombstones
+void InvertedPageTable::eraseBucket(size_t slot) {
+    const size_t mask = buckets.size() - 1;
+    size_t hole = slot;
+    size_t next = (slot + 1) & mask;
+
+    while (buckets[next] != -1) {
+        const size_t home = homeBucket(frameVpn[buckets[next]]);
+        // move the entry back if the hole lies between its home and its slot
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            buckets[hole] = buckets[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    buckets[hole] = -1;
+    used--;
+}
+
+void InvertedPageTable::grow() {
+    bucketBits++;
+    buckets.assign((size_t)1 << bucketBits, -1);
+    used = 0;
+
+    const size_t mask = buckets.size() - 1;
+    for (size_t pfn = 0; pfn < frames.size(); pfn++) {
+        if (!frames[pfn].valid) continue;
+        size_t slot = homeBucket(frameVpn[pfn]);
+        while (buckets[slot] != -1) slot = (slot + 1) & mask;
+        buckets[slot] = (int)pfn;
+        used++;
+    }
+    syncStats();
+}
+
+// searches and returns the Map for the given virtual address
+Map* InvertedPageTable::searchMappedPfn(uint64_t virtualAddress) {
+    const long slot = findBucket(virtualAddress >> offsetBits);
+    if (slot < 0) {
+        return nullptr;
+    }
+    Map& mapping = frames[buckets[slot]];
+    return mapping.valid ? &mapping : nullptr;
+}
+
+// inserts a mapping from the given virtual address to the given frame number, returns it
+Map* InvertedPageTable::insertMapForVpn2Pfn(uint64_t virtualAddress, int frame) {
+    const uint64_t vpn = virtualAddress >> offsetBits;
+
+    // frames are handed out in order, so the frame table grows one entry at a time
+    if ((size_t)frame >= frames.size()) {
+        frames.resize(frame + 1);
+        frameVpn.resize(frame + 1, 0);
+        syncStats();
+    }
+
+    // drop a stale bucket for this VPN (its frame may have been invalidated)
+    long slot = findBucket(vpn);
+    if (slot >= 0) {
+        const int oldFrame = buckets[slot];
+        eraseBucket(slot);
+        if (oldFrame != frame) frames[oldFrame].valid = false;
+    }
+
+    // drop the bucket of whatever page this frame held before
+    if (frames[frame].pfn != -1) {
+        slot = findBucket(frameVpn[frame]);
+        if (slot >= 0 && buckets[slot] == frame) eraseBucket(slot);
+    }
+
+    frames[frame].pfn = frame;
+    frames[frame].valid = true;
+    frames[frame].dirty = false;
+    frameVpn[frame] = vpn;
+
+    if (2 * (used + 1) > buckets.size() && bucketBits < maxBucketBits) {
+        grow(); // rehash picks up this frame since it is already valid
+        return &frames[frame];
+    }
+
+    const size_t mask = buckets.size() - 1;
+    size_t home = homeBucket(vpn);
+    while (buckets[home] != -1) home = (home + 1) & mask;
+    buckets[home] = frame;
+    used++;
+    return &frames[frame];
+}
+
+// invalidates the mapping for the given virtual address and frees its bucket
+void InvertedPageTable::removeMapForVpn2Pfn(uint64_t virtualAddress) {
+    const long slot = findBucket(virtualAddress >> offsetBits);
+    if (slot < 0) {
+        return;
+    }
+    frames[buckets[slot]].valid = false;
+    eraseBucket(slot);
+}
@@ -0,0 +1,134 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "latencyModel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+bool parseLatencySpec(const string& spec, LatencyConfig& config) {
+    size_t pos = 0;
+    while (pos < spec.size()) {
+        const size_t comma = spec.find(',', pos);
+        const string field = spec.substr(pos, comma == string::npos ? string::npos : comma - pos);
+        pos = (comma == string::npos) ? spec.size() : comma + 1;
+
+        const size_t eq = field.find('=');
+        if (eq == string::npos) return false;
+        const string key = field.substr(0, eq);
+        const string value = field.substr(eq + 1);
+        if (value.empty() || value.find_first_not_of("0123456789") != string::npos) {
+            return false;
+        }
+        const uint64_t n = (uint64_t)atoll(value.c_str());
+
+        if (key == "tlb") {
+            config.tlbHit = n;
+        } else if (key == "walk") {
+            config.walkLevel = n;
+        } else if (key == "mem") {
+            config.memory = n;
+        } else if (key == "minor") {
+            config.minorFault = n;
+        } else if (key == "major") {
+            config.majorFault = n;
+        } else if (key == "io") {
+            config.ioService = n;
+        } else if (key == "qd" && n >= 1 && n <= 1024) {
+            config.queueDepth = (unsigned)n;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  LatencyHistogram
+
+  Values below 2^SUB_BITS get a bucket each. Above that a value keeps its
+  top SUB_BITS bits: shift = bits dropped, top in [2^(SUB_BITS-1), 2^SUB_BITS),
+  and bucket = shift * 2^(SUB_BITS-1) + top, which continues right after the
+  exact buckets.
+───────────────────────────────────────────────────────────────────────────────*/
+LatencyHistogram::LatencyHistogram() {
+    counts.assign(bucketOf(UINT64_MAX) + 1, 0);
+}
+
+size_t LatencyHistogram::bucketOf(uint64_t value) {
+    const int msb = value == 0 ? 0 : 63 - __builtin_clzll(value);
+    const int shift = msb < SUB_BITS ? 0 : msb - SUB_BITS + 1;
+    return ((size_t)shift << (SUB_BITS - 1)) + (size_t)(value >> shift);
+}
+
+uint64_t LatencyHistogram::highestIn(size_t bucket) {
+    const size_t half = (size_t)1 << (SUB_BITS - 1);
+    if (bucket < 2 * half) {
+        return bucket;
+    }
+    const int shift = (int)(bucket / half) - 1;
+    const uint64_t top = bucket - (size_t)shift * half;
+    return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    counts[bucketOf(value)]++;
+    total++;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    if (total == 0) return 0;
+    uint64_t rank = (uint64_t)ceil(q * (double)total);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < counts.size(); bucket++) {
+        seen += counts[bucket];
+        if (seen >= rank) return highestIn(bucket);
+    }
+    return UINT64_MAX;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  LatencyModel
+───────────────────────────────────────────────────────────────────────────────*/
+void LatencyModel::init(const LatencyConfig& config_, unsigned walkLevels_) {
+    config = config_;
+    enabled = true;
+    walkLevels = walkLevels_;
+    now = 0;
+    faultTime = 0;
+    faults = LatencyHistogram();
+    slotFree.assign(config.queueDepth, 0);
+}
+
+uint64_t LatencyModel::issueIO() {
+    auto slot = min_element(slotFree.begin(), slotFree.end());
+    *slot = max(*slot, now) + config.ioService;
+    return *slot;
+}
+
+void LatencyModel::minorFault(unsigned skipped) {
+    if (!enabled) return;
+    const uint64_t fault = config.minorFault;
+    now += config.tlbHit + config.memory + (walkLevels - skipped) * config.walkLevel + fault;
+    faultTime += fault;
+    faults.record(fault);
+}
+
+void LatencyModel::majorFault(unsigned skipped, bool writeBack) {
+    if (!enabled) return;
+    now += config.tlbHit + (walkLevels - skipped) * config.walkLevel + config.majorFault;
+    if (writeBack) {
+        issueIO(); // victim write-back, not waited on
+    }
+    const uint64_t readDone = issueIO();
+
+    const uint64_t fault = config.majorFault + (readDone - now);
+    now = readDone + config.memory;
+    faultTime += fault;
+    faults.record(fault);
+}
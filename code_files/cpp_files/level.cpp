@@ -6,6 +6,8 @@
 
 #include "level.h"
 #include <cstdlib>
+#include <cstring>
+#include <new>
 
 // Destructor
 Level::~Level() {
@@ -13,7 +15,15 @@ Level::~Level() {
         // delete mappings array
         delete[] mappings;
         mappings = nullptr;
-    } 
+        if (stats) stats->released(entryCount, entryCount * sizeof(Map));
+    }
+    if (sparse) {
+        // delete the packed children recursively
+        for (unsigned i = 0; i < liveCount; i++) {
+            delete children[i];
+        }
+        freeSparse();
+    }
     if (children) {
         // delete children levels recursively
         for (unsigned i = 0; i < entryCount; i++) {
@@ -21,16 +31,29 @@ Level::~Level() {
         }
         delete[] children;
         children = nullptr;
+        if (stats) stats->released(entryCount, entryCount * sizeof(Level*));
     }
+    if (stats) stats->nodeDestroyed(depth, sizeof(Level));
 }
 
-// if is not a leaf and children is null, allocate children array
+// if is not a leaf and children is null, allocate children array (or the
+// empty sparse index, the packed array grows as children arrive)
 void Level::allocateChildren() {
-    if (!isLeaf && !children) {
+    if (!isLeaf && !children && !sparse) {
+        if (sparseFill) {
+            const unsigned words = (entryCount + 63) / 64;
+            sparse = static_cast<SparseIndex*>(::operator new(SparseIndex::blockBytes(words)));
+            sparse->capacity = 0;
+            sparse->words = words;
+            memset(sparse->bitmap(), 0, words * (sizeof(uint64_t) + sizeof(uint32_t)));
+            if (stats) stats->allocated(0, SparseIndex::blockBytes(words));
+            return;
+        }
         children = new Level*[entryCount];
         for(unsigned i = 0; i < entryCount; i++) {
             children[i] = nullptr;
         }
+        if (stats) stats->allocated(entryCount, entryCount * sizeof(Level*));
     }
 }
 
@@ -38,16 +61,115 @@ void Level::allocateChildren() {
 void Level::allocateMappings() {
     if (isLeaf && !mappings) {
         mappings = new Map[entryCount];
+        if (stats) stats->allocated(entryCount, entryCount * sizeof(Map));
     }
 }
 
 // ensures a child exists at the given index, allocating if necessary
 Level* Level::ensureChild(unsigned index, unsigned childEntryCount, bool childIsLeaf) {
-    if (!children) {
+    if (!children && !sparse) {
         allocateChildren();
     }
+    if (sparse) {
+        Level* child = getChild(index);
+        if (child) return child;
+        // past the fill threshold a full array costs less than the packed one plus its index
+        if ((uint64_t)(liveCount + 1) * 100 > (uint64_t)entryCount * sparseFill) {
+            makeDense();
+        } else {
+            child = new Level(childEntryCount, childIsLeaf, depth + 1, stats, sparseFill);
+            insertSparseChild(index, child);
+            liveCount++;
+            return child;
+        }
+    }
     if (!children[index]) {
-        children[index] = new Level(childEntryCount, childIsLeaf, depth + 1);
+        children[index] = new Level(childEntryCount, childIsLeaf, depth + 1, stats, sparseFill);
+        liveCount++;
     }
     return children[index];
-}
\ No newline at end of file
+}
+
+// frees the child at the given index, dropping this level's live count
+void Level::releaseChild(unsigned index) {
+    if (sparse) {
+        if (!getChild(index)) return;
+        const unsigned slot = sparse->slotOf(index);
+        delete children[slot];
+        memmove(children + slot, children + slot + 1, (liveCount - slot - 1) * sizeof(Level*));
+        sparse->bitmap()[index >> 6] &= ~(1ull << (index & 63));
+        uint32_t* rank = sparse->rank();
+        for (unsigned w = (index >> 6) + 1; w < sparse->words; w++) rank[w]--;
+        liveCount--;
+        return;
+    }
+    if (children && children[index]) {
+        delete children[index];
+        children[index] = nullptr;
+        liveCount--;
+    }
+}
+
+// frees the child pointer / mapping array when no live entries remain in it
+void Level::releaseStorage() {
+    if (liveCount != 0) return;
+    if (mappings) {
+        delete[] mappings;
+        mappings = nullptr;
+        if (stats) stats->released(entryCount, entryCount * sizeof(Map));
+    }
+    if (sparse) {
+        freeSparse(); // back to unallocated, the next child starts a new sparse index
+    }
+    if (children) {
+        delete[] children; // every slot is already null since liveCount is 0
+        children = nullptr;
+        if (stats) stats->released(entryCount, entryCount * sizeof(Level*));
+    }
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Sparse levels. The packed array doubles when full; installing or freeing
+  a child shifts the packed slots after it and the ranks of the words
+  after its own, which is O(children + entryCount / 64) per change but
+  leaves lookups at one popcount.
+───────────────────────────────────────────────────────────────────────────────*/
+void Level::insertSparseChild(unsigned index, Level* child) {
+    if (liveCount == sparse->capacity) {
+        const unsigned capacity = sparse->capacity ? sparse->capacity * 2 : 2;
+        Level** grown = new Level*[capacity];
+        if (liveCount) memcpy(grown, children, liveCount * sizeof(Level*));
+        delete[] children;
+        children = grown;
+        if (stats) stats->allocated(capacity - sparse->capacity, (capacity - sparse->capacity) * sizeof(Level*));
+        sparse->capacity = capacity;
+    }
+
+    const unsigned slot = sparse->slotOf(index);
+    memmove(children + slot + 1, children + slot, (liveCount - slot) * sizeof(Level*));
+    children[slot] = child;
+    sparse->bitmap()[index >> 6] |= 1ull << (index & 63);
+    uint32_t* rank = sparse->rank();
+    for (unsigned w = (index >> 6) + 1; w < sparse->words; w++) rank[w]++;
+}
+
+void Level::makeDense() {
+    Level** dense = new Level*[entryCount];
+    for (unsigned i = 0; i < entryCount; i++) {
+        dense[i] = nullptr;
+    }
+    if (stats) stats->allocated(entryCount, entryCount * sizeof(Level*));
+    forEachChild([&](unsigned index, Level* child) { dense[index] = child; });
+    freeSparse();
+    children = dense;
+}
+
+void Level::freeSparse() {
+    if (stats) {
+        stats->released(sparse->capacity, sparse->capacity * sizeof(Level*) + SparseIndex::blockBytes(sparse->words));
+    }
+    delete[] children;
+    children = nullptr;
+    ::operator delete(sparse);
+    sparse = nullptr;
+}
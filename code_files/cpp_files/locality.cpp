@@ -0,0 +1,227 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "locality.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+static const size_t INITIAL_SLOTS  = 1 << 16; // timestamp slots before the first compaction
+static const size_t SKETCH_WIDTH   = 1 << 14; // count-min counters per row
+
+/*───────────────────────────────────────────────────────────────────────────────
+  TimestampTree
+───────────────────────────────────────────────────────────────────────────────*/
+void TimestampTree::init(size_t capacity) {
+    tree.assign(capacity + 1, 0);
+    accessAt.assign(capacity + 1, 0);
+    used = 0;
+}
+
+void TimestampTree::add(size_t slot, int64_t delta) {
+    for (; slot < tree.size(); slot += slot & (~slot + 1)) {
+        tree[slot] += delta;
+    }
+}
+
+int64_t TimestampTree::prefix(size_t slot) const {
+    int64_t sum = 0;
+    for (; slot > 0; slot -= slot & (~slot + 1)) {
+        sum += tree[slot];
+    }
+    return sum;
+}
+
+size_t TimestampTree::firstSlotAfter(uint64_t access) const {
+    const auto begin = accessAt.begin() + 1;
+    return (size_t)(upper_bound(begin, begin + used, access) - accessAt.begin());
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  CountMinSketch
+
+  Row r hashes the key with its own odd multiplier (Fibonacci hashing, as in
+  the inverted page table) after mixing in the row number.
+───────────────────────────────────────────────────────────────────────────────*/
+void CountMinSketch::init(size_t width_) {
+    width = width_;
+    counters.assign((size_t)DEPTH * width, 0);
+}
+
+uint64_t CountMinSketch::add(uint64_t key) {
+    static const uint64_t multipliers[DEPTH] = {
+        0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL, 0xD6E8FEB86659FD93ULL
+    };
+    uint64_t estimate = UINT64_MAX;
+    for (int row = 0; row < DEPTH; row++) {
+        const uint64_t h = (key ^ (uint64_t)row << 59) * multipliers[row];
+        uint64_t& counter = counters[(size_t)row * width + (size_t)((h >> 32) % width)];
+        counter++;
+        estimate = min(estimate, counter);
+    }
+    return estimate;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  LocalityAnalyzer
+───────────────────────────────────────────────────────────────────────────────*/
+void LocalityAnalyzer::init(const LocalityOptions& opts_) {
+    opts = opts_;
+    accesses = 0;
+    coldAccesses = 0;
+    reuseBuckets.assign(1, 0);
+    lastSlot.clear();
+    times.init(INITIAL_SLOTS);
+    sketch.init(SKETCH_WIDTH);
+    hot.clear();
+    workingSet.clear();
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  One page reference at time t = accesses.
+
+  - Reuse distance: distinct pages referenced since this page's previous
+    access = live slots after its previous slot.
+  - W(t, tau): distinct pages whose latest access falls in (t - tau, t].
+───────────────────────────────────────────────────────────────────────────────*/
+void LocalityAnalyzer::access(uint64_t vpn) {
+    accesses++;
+    if (times.used + 1 >= times.tree.size()) {
+        compact();
+    }
+
+    auto it = lastSlot.find(vpn);
+    if (it != lastSlot.end()) {
+        const size_t previous = it->second;
+        const uint64_t distance = (uint64_t)(times.prefix(times.used) - times.prefix(previous));
+        const size_t bucket = distance == 0 ? 0 : (size_t)(64 - __builtin_clzll(distance));
+        if (bucket >= reuseBuckets.size()) {
+            reuseBuckets.resize(bucket + 1, 0);
+        }
+        reuseBuckets[bucket]++;
+        times.add(previous, -1);
+    } else {
+        coldAccesses++;
+    }
+
+    const size_t slot = ++times.used;
+    times.accessAt[slot] = accesses;
+    times.add(slot, 1);
+    lastSlot[vpn] = slot;
+
+    trackHot(vpn, sketch.add(vpn));
+
+    if (accesses % opts.tau == 0) {
+        finish();
+    }
+}
+
+void LocalityAnalyzer::finish() {
+    if (accesses == 0 || (!workingSet.empty() && workingSet.back().first == accesses)) {
+        return;
+    }
+    const uint64_t windowStart = accesses > opts.tau ? accesses - opts.tau : 0;
+    const size_t first = times.firstSlotAfter(windowStart);
+    const int64_t pages = times.prefix(times.used) - times.prefix(first - 1);
+    workingSet.push_back({ accesses, (uint64_t)pages });
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Renumbers the live slots (one per distinct page) 1..m in order, dropping
+  the dead ones. Doubles the tree when more than half of it stays live.
+───────────────────────────────────────────────────────────────────────────────*/
+void LocalityAnalyzer::compact() {
+    vector<pair<size_t, uint64_t>> live; // (slot, VPN)
+    live.reserve(lastSlot.size());
+    for (const auto& entry : lastSlot) {
+        live.push_back({ entry.second, entry.first });
+    }
+    sort(live.begin(), live.end());
+
+    size_t capacity = times.tree.size() - 1;
+    if (live.size() * 2 > capacity) {
+        capacity *= 2;
+    }
+
+    vector<uint64_t> accessAt(capacity + 1, 0);
+    for (size_t i = 0; i < live.size(); i++) {
+        accessAt[i + 1] = times.accessAt[live[i].first];
+        lastSlot[live[i].second] = i + 1;
+    }
+
+    times.init(capacity);
+    times.accessAt.swap(accessAt);
+    times.used = live.size();
+
+    // linear-time Fenwick build: every live slot holds 1, every node passes its sum up
+    for (size_t slot = 1; slot <= capacity; slot++) {
+        if (slot <= times.used) {
+            times.tree[slot] += 1;
+        }
+        const size_t parent = slot + (slot & (~slot + 1));
+        if (parent <= capacity) {
+            times.tree[parent] += times.tree[slot];
+        }
+    }
+}
+
+// Keeps the topK pages with the highest estimates seen so far
+void LocalityAnalyzer::trackHot(uint64_t vpn, uint64_t estimate) {
+    size_t coldest = 0;
+    for (size_t i = 0; i < hot.size(); i++) {
+        if (hot[i].first == vpn) {
+            hot[i].second = estimate;
+            return;
+        }
+        if (hot[i].second < hot[coldest].second) {
+            coldest = i;
+        }
+    }
+
+    if (hot.size() < opts.topK) {
+        hot.push_back({ vpn, estimate });
+    } else if (opts.topK > 0 && estimate > hot[coldest].second) {
+        hot[coldest] = { vpn, estimate };
+    }
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  CSV output. Hot pages also list their per-level table indices, split with
+  the page table's level bits.
+───────────────────────────────────────────────────────────────────────────────*/
+void printLocalityCsv(const LocalityAnalyzer& analyzer, const PageTable& pt) {
+    printf("reuse_distance_min,reuse_distance_max,accesses\n");
+    for (size_t bucket = 0; bucket < analyzer.reuseBuckets.size(); bucket++) {
+        const uint64_t low  = bucket == 0 ? 0 : (uint64_t)1 << (bucket - 1);
+        const uint64_t high = bucket == 0 ? 0 : ((uint64_t)1 << (bucket - 1)) * 2 - 1;
+        printf("%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n", low, high, analyzer.reuseBuckets[bucket]);
+    }
+    printf("cold,cold,%" PRIu64 "\n", analyzer.coldAccesses);
+
+    printf("\naccess,tau,working_set_pages\n");
+    for (const auto& sample : analyzer.workingSet) {
+        printf("%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n", sample.first, analyzer.opts.tau, sample.second);
+    }
+
+    vector<pair<uint64_t, uint64_t>> hot = analyzer.hot;
+    sort(hot.begin(), hot.end(), [](const pair<uint64_t, uint64_t>& a, const pair<uint64_t, uint64_t>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+
+    printf("\nrank,vpn,estimated_accesses");
+    for (int level = 0; level < pt.numLevels; level++) {
+        printf(",level%d", level);
+    }
+    printf("\n");
+    for (size_t rank = 0; rank < hot.size(); rank++) {
+        const uint64_t vpn = hot[rank].first;
+        printf("%zu,%08" PRIX64 ",%" PRIu64, rank + 1, vpn, hot[rank].second);
+        for (int level = 0; level < pt.numLevels; level++) {
+            printf(",%X", pt.getVPNPiece(vpn << pt.offsetBits, level));
+        }
+        printf("\n");
+    }
+}
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <inttypes.h>
 #include "log_helpers.h"
 
 /* Handle C++ namespaces, ignore if compiled in C 
@@ -13,8 +14,8 @@ using namespace std;
  * @brief Print out a number in hex, one per line
  * @param number 
  */
-void print_num_inHex(uint32_t number) {
-  printf("%08X\n", number);
+void print_num_inHex(uint64_t number) {
+  printf("%08" PRIX64 "\n", number);
   fflush(stdout);
 }
 
@@ -24,11 +25,11 @@ void print_num_inHex(uint32_t number) {
  * @param levels - Number of levels
  * @param masks - Pointer to array of bitmasks
  */
-void log_bitmasks(int levels, uint32_t *masks) {
+void log_bitmasks(int levels, const uint64_t *masks) {
   printf("Bitmasks\n");
   for (int idx = 0; idx < levels; idx++) 
     /* show mask entry and move to next */
-    printf("level %d mask %08X\n", idx, masks[idx]);
+    printf("level %d mask %08" PRIX64 "\n", idx, masks[idx]);
 
   fflush(stdout);
 }
@@ -40,11 +41,22 @@ void log_bitmasks(int levels, uint32_t *masks) {
  * @param va 
  * @param pa 
  */
-void log_va2pa(uint32_t va, uint32_t pa) {
-  fprintf(stdout, "%08X -> %08X\n", va, pa);
+void log_va2pa(uint64_t va, uint64_t pa) {
+  char line[LOG_LINE_MAX];
+  format_va2pa(line, sizeof(line), va, pa);
+  fputs(line, stdout);
   fflush(stdout);
 }
 
+/**
+ * @brief format the log_va2pa line into buf (same text, no output)
+ * 
+ * @return number of characters written, as snprintf
+ */
+int format_va2pa(char *buf, size_t len, uint64_t va, uint64_t pa) {
+  return snprintf(buf, len, "%08" PRIX64 " -> %08" PRIX64 "\n", va, pa);
+}
+
 /**
  * @brief Given a pair of numbers, output a line: 
  *        src -> dest  
@@ -65,27 +77,37 @@ void log_va2pa(uint32_t va, uint32_t pa) {
  * @param pagereplace
  * @param pthit 
  */
-void log_mapping(uint32_t src, uint32_t dest, 
-                 int vpnreplaced,
+void log_mapping(uint64_t src, uint64_t dest, 
+                 int64_t vpnreplaced,
                  unsigned int victim_bitstring,
                  bool pthit) {
-  
-  fprintf(stdout, "%08X -> %08X, ", src, dest);
-
-  fprintf(stdout, "pagetable %s", pthit ? "hit" : "miss");
-  
-  if (vpnreplaced != -1) // vpn was replaced due to page replacement
-    fprintf(stdout, 
-            ", %08X page (with bitstring %04X) was replaced\n", 
-            vpnreplaced,
-            victim_bitstring);
-  else {
-    fprintf(stdout, "\n");
-  }
-
+  char line[LOG_LINE_MAX];
+  format_mapping(line, sizeof(line), src, dest, vpnreplaced, victim_bitstring, pthit);
+  fputs(line, stdout);
   fflush(stdout);
 }
 
+/**
+ * @brief format the log_mapping line into buf (same text, no output)
+ * 
+ * @return number of characters written, as snprintf
+ */
+int format_mapping(char *buf, size_t len,
+                   uint64_t src, uint64_t dest, 
+                   int64_t vpnreplaced,
+                   unsigned int victim_bitstring,
+                   bool pthit) {
+  if (vpnreplaced != -1) /* vpn was replaced due to page replacement */
+    return snprintf(buf, len,
+                    "%08" PRIX64 " -> %08" PRIX64 ", pagetable %s"
+                    ", %08" PRIX64 " page (with bitstring %04X) was replaced\n",
+                    src, dest, pthit ? "hit" : "miss",
+                    vpnreplaced, victim_bitstring);
+
+  return snprintf(buf, len, "%08" PRIX64 " -> %08" PRIX64 ", pagetable %s\n",
+                  src, dest, pthit ? "hit" : "miss");
+}
+
 /**
  * @brief log vpns at all levels and the mapped physical frame number
  * 
@@ -95,13 +117,29 @@ void log_mapping(uint32_t src, uint32_t dest,
  * @param frame - page is mapped to specified physical frame
  */
 void log_vpns_pfn(int levels, uint32_t *vpns, uint32_t frame) {
+  char line[LOG_LINE_MAX];
+  format_vpns_pfn(line, sizeof(line), levels, vpns, frame);
+  fputs(line, stdout);
+
+  fflush(stdout);
+}
+
+/**
+ * @brief format the log_vpns_pfn line into buf (same text, no output)
+ * 
+ * @return number of characters written, or that would have been written
+ *         if buf had been large enough (as snprintf)
+ */
+int format_vpns_pfn(char *buf, size_t len, int levels, uint32_t *vpns, uint32_t frame) {
+  size_t used = 0;
   /* output pages */
   for (int idx=0; idx < levels; idx++)
-    printf("%X ", vpns[idx]);
+    used += snprintf(buf + (used < len ? used : len), used < len ? len - used : 0,
+                     "%X ", vpns[idx]);
   /* output frame */
-  printf("-> %X\n", frame);
-
-  fflush(stdout);
+  used += snprintf(buf + (used < len ? used : len), used < len ? len - used : 0,
+                   "-> %X\n", frame);
+  return (int) used;
 }
 
 /**
@@ -114,27 +152,233 @@ void log_vpns_pfn(int levels, uint32_t *vpns, uint32_t frame) {
  * @param numOfFramesAllocated - Number of frames allocated
  * @param pgtableEntries - Total number of page table entries across all levels.
  */
-void log_summary(unsigned int page_size, 
-                 unsigned int numOfPageReplaces,
-                 unsigned int pageTableHits, 
-                 unsigned int numOfAddresses, 
-                 unsigned int numOfFramesAllocated,
-                 unsigned long int pgtableEntries) {
-  unsigned int misses;
+void log_summary(uint64_t page_size, 
+                 uint64_t numOfPageReplaces,
+                 uint64_t pageTableHits, 
+                 uint64_t numOfAddresses, 
+                 uint64_t numOfFramesAllocated,
+                 uint64_t pgtableEntries) {
+  uint64_t misses;
   double hit_percent;
 
-  printf("Page size: %d bytes\n", page_size);
+  printf("Page size: %" PRIu64 " bytes\n", page_size);
   /* Compute misses (page faults) and hit percentage */
   misses = numOfAddresses - pageTableHits;
   hit_percent = (double) (pageTableHits) / (double) numOfAddresses * 100.0;
-  printf("Addresses processed: %d\n", numOfAddresses);
-  printf("Page hits: %d, Misses: %d, Page Replacements: %d\n", 
+  printf("Addresses processed: %" PRIu64 "\n", numOfAddresses);
+  printf("Page hits: %" PRIu64 ", Misses: %" PRIu64 ", Page Replacements: %" PRIu64 "\n", 
          pageTableHits, misses, numOfPageReplaces);
   printf("Page hit percentage: %.2f%%, miss percentage: %.2f%%\n", 
          hit_percent, 100 - hit_percent);
-  printf("Frames allocated: %d\n", numOfFramesAllocated);
-  printf("Number of page table entries: %ld\n", pgtableEntries);
+  printf("Frames allocated: %" PRIu64 "\n", numOfFramesAllocated);
+  printf("Number of page table entries: %" PRIu64 "\n", pgtableEntries);
+
+  fflush(stdout);
+}
+
+/**
+ * @brief log page table memory usage, printed after log_summary.
+ * 
+ * @param pgtableBytes - Bytes currently held by the page table
+ * @param peakBytes - Largest number of bytes held at any point of the run
+ * @param peakEntries - Largest number of page table entries at any point of the run
+ */
+void log_pagetable_usage(uint64_t pgtableBytes,
+                         uint64_t peakBytes,
+                         uint64_t peakEntries) {
+  printf("Page table bytes: %" PRIu64 ", peak bytes: %" PRIu64 ", peak entries: %" PRIu64 "\n",
+         pgtableBytes, peakBytes, peakEntries);
+
+  fflush(stdout);
+}
+
+/**
+ * @brief log dirty page write-backs, printed after log_pagetable_usage.
+ * 
+ * @param writeBacks - Evicted pages that were dirty and written back
+ * @param pageSize - Bytes per page
+ * @param replacements - Page replacements (evictions by demand faults)
+ */
+void log_write_backs(uint64_t writeBacks,
+                     uint64_t pageSize,
+                     uint64_t replacements) {
+  const double dirty_percent = replacements ? (double) writeBacks / (double) replacements * 100.0 : 0.0;
+
+  printf("Dirty page write-backs: %" PRIu64 ", bytes written back: %" PRIu64 ", per replacement: %.2f%%\n",
+         writeBacks, writeBacks * pageSize, dirty_percent);
+
+  fflush(stdout);
+}
+
+/**
+ * @brief log hit / miss counts of one data cache level, printed after
+ * log_pagetable_usage.
+ * 
+ * @param level - Cache level, 1 for L1
+ * @param hits - Accesses that found their line in this level
+ * @param misses - Accesses that went on to the next level (or memory)
+ */
+void log_cache_level(int level,
+                     uint64_t hits,
+                     uint64_t misses) {
+  const uint64_t accesses = hits + misses;
+  const double hit_percent = accesses ? (double) hits / (double) accesses * 100.0 : 0.0;
+
+  printf("L%d cache accesses: %" PRIu64 ", hits: %" PRIu64 ", misses: %" PRIu64 ", hit percentage: %.2f%%\n",
+         level, accesses, hits, misses, hit_percent);
+
+  fflush(stdout);
+}
+
+/**
+ * @brief log page walk cache use, printed after log_pagetable_usage.
+ * 
+ * @param walks - Demand table walks (one per access that searched the table) done with the cache on
+ * @param resumedAt - resumedAt[d]: walks that started from a cached level at depth d
+ * @param depths - Number of entries in resumedAt (the page table's level count)
+ */
+void log_walk_cache(uint64_t walks,
+                    const uint64_t *resumedAt,
+                    int depths) {
+  uint64_t hits = 0;
+  for (int depth = 1; depth < depths; depth++)
+    hits += resumedAt[depth];
+  const double hit_percent = walks ? (double) hits / (double) walks * 100.0 : 0.0;
+
+  printf("Page walk cache walks: %" PRIu64 ", hits: %" PRIu64 ", hit percentage: %.2f%%, resumed at depth",
+         walks, hits, hit_percent);
+  for (int depth = 1; depth < depths; depth++)
+    printf(" %d: %" PRIu64 "%s", depth, resumedAt[depth], depth + 1 < depths ? "," : "");
+  printf("\n");
+
+  fflush(stdout);
+}
+
+/**
+ * @brief log prefetch effectiveness, printed after log_pagetable_usage.
+ * 
+ * Accuracy is used / issued; coverage is the share of would-be misses that
+ * prefetching turned into hits, used / (used + misses).
+ * 
+ * @param issued - Pages prefetched
+ * @param used - Prefetched pages referenced before their eviction
+ * @param polluted - Prefetched pages evicted without ever being referenced
+ * @param misses - Demand misses left
+ */
+void log_prefetch(uint64_t issued,
+                  uint64_t used,
+                  uint64_t polluted,
+                  uint64_t misses) {
+  const double accuracy = issued ? (double) used / (double) issued * 100.0 : 0.0;
+  const double coverage = used + misses ? (double) used / (double) (used + misses) * 100.0 : 0.0;
+
+  printf("Prefetches: %" PRIu64 ", used: %" PRIu64 ", evicted unused: %" PRIu64
+         ", accuracy: %.2f%%, coverage: %.2f%%\n",
+         issued, used, polluted, accuracy, coverage);
+
+  fflush(stdout);
+}
+
+/**
+ * @brief log the per-process frame allocation policy, printed after
+ * log_pagetable_usage and followed by one log_process_frames line per process.
+ * 
+ * @param policy - Policy name (fixed, pff, wsclock)
+ * @param quotaChanges - Times a quota moved after its first setting
+ */
+void log_frame_allocation(const char *policy,
+                          uint64_t quotaChanges) {
+  printf("Frame allocation: %s, quota changes: %" PRIu64 "\n", policy, quotaChanges);
 
   fflush(stdout);
 }
 
+/**
+ * @brief log the frame use of one process.
+ * 
+ * @param proc - Process number (trace proc field)
+ * @param accesses - Accesses the process made
+ * @param faults - Its demand faults
+ * @param quota - Frames it may hold at the end of the run
+ * @param resident - Frames it holds at the end of the run
+ * @param peakResident - Most frames it held at once
+ */
+void log_process_frames(int proc,
+                        uint64_t accesses,
+                        uint64_t faults,
+                        int quota,
+                        int resident,
+                        int peakResident) {
+  const double fault_percent = accesses ? (double) faults / (double) accesses * 100.0 : 0.0;
+
+  printf("  Process %d: accesses: %" PRIu64 ", faults: %" PRIu64 " (%.2f%%), quota: %d, resident: %d, peak: %d\n",
+         proc, accesses, faults, fault_percent, quota, resident, peakResident);
+
+  fflush(stdout);
+}
+
+/**
+ * @brief log the latency model's totals, printed after log_pagetable_usage.
+ * 
+ * @param totalTime - Memory access time of the whole run, in ns
+ * @param numOfAddresses - Number of addresses processed
+ * @param faults - Number of faults (minor and major)
+ * @param faultTime - Part of totalTime spent serving faults, in ns
+ * @param p50 - Median fault latency, in ns
+ * @param p99 - 99th percentile fault latency, in ns
+ * @param p999 - 99.9th percentile fault latency, in ns
+ */
+void log_latency_summary(uint64_t totalTime,
+                         uint64_t numOfAddresses,
+                         uint64_t faults,
+                         uint64_t faultTime,
+                         uint64_t p50,
+                         uint64_t p99,
+                         uint64_t p999) {
+  const double amat = numOfAddresses ? (double) totalTime / (double) numOfAddresses : 0.0;
+
+  printf("Memory access time: %" PRIu64 " ns, average: %.2f ns\n", totalTime, amat);
+  printf("Fault service time: %" PRIu64 " ns over %" PRIu64 " faults, p50: %" PRIu64 " ns, p99: %" PRIu64
+         " ns, p999: %" PRIu64 " ns\n",
+         faultTime, faults, p50, p99, p999);
+
+  fflush(stdout);
+}
+
+/**
+ * @brief log extrapolated statistics of a sampled run.
+ * 
+ * Percentages are per-window means; the +/- values are 95% confidence
+ * half widths. Estimated counts scale the percentages to totalAccesses.
+ * 
+ * @param page_size - Number of bytes per page
+ * @param windows - Number of measured windows
+ * @param measuredAccesses - Accesses inside measured windows
+ * @param totalAccesses - Accesses the estimate is extrapolated to
+ * @param hitPercent - Mean page hit percentage
+ * @param hitHalfWidth - Confidence half width of hitPercent
+ * @param replacePercent - Mean page replacement percentage
+ * @param replaceHalfWidth - Confidence half width of replacePercent
+ */
+void log_sampled_summary(uint64_t page_size,
+                         uint64_t windows,
+                         uint64_t measuredAccesses,
+                         uint64_t totalAccesses,
+                         double hitPercent, double hitHalfWidth,
+                         double replacePercent, double replaceHalfWidth) {
+  double total = (double) totalAccesses;
+
+  printf("Page size: %" PRIu64 " bytes\n", page_size);
+  printf("Sampled windows: %" PRIu64 ", accesses measured: %" PRIu64 " of %" PRIu64 "\n",
+         windows, measuredAccesses, totalAccesses);
+  printf("Page hit percentage: %.2f%% (+/- %.2f%%), miss percentage: %.2f%%\n",
+         hitPercent, hitHalfWidth, 100 - hitPercent);
+  printf("Page replacement percentage: %.2f%% (+/- %.2f%%)\n",
+         replacePercent, replaceHalfWidth);
+  printf("Estimated page hits: %.0f (+/- %.0f), Misses: %.0f, Page Replacements: %.0f (+/- %.0f)\n",
+         total * hitPercent / 100.0, total * hitHalfWidth / 100.0,
+         total * (100 - hitPercent) / 100.0,
+         total * replacePercent / 100.0, total * replaceHalfWidth / 100.0);
+
+  fflush(stdout);
+}
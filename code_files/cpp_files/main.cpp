@@ -5,30 +5,133 @@
  * Program overview:
  * - Builds a multi-level page table from level bit widths.
  * - Reads a binary virtual-address trace and simulates translation + NFU replacement.
- * - Supports multiple logging modes (bitmasks, va2pa, vpns_pfn, offset, summary, vpn2pfn_pr).
+ * - Supports multiple logging modes (bitmasks, va2pa, vpns_pfn, offset, summary, vpn2pfn_pr, sampled, locality, compare, scaling, tune).
  *
  * Key collaborators (headers you provide):
  *   log_helpers.h     : logging/printing helpers (e.g., log_va2pa, log_summary, etc.)
  *   pageTable.h       : PageTable class (init, indexing, mapping insert/search, etc.)
- *   vaddr_tracereader.h : NextAddress() that yields p2AddrTr { uint32_t addr; ... }
- *   nfu.h             : NFU state + APIs (initNFUState, onHitNFU, onMissNFU, isFullNFU, selectVictimNFU, reuseSlotNFU, beforeAccessNFU, nfuState)
+ *   vaddr_tracereader.h : p2AddrTr / p2AddrTr64 record layouts and byte order conversion
+ *   simulation.h      : Simulator (page table + NFU state + counters), the per-access translate + replace step shared by all modes
+ *   checkpoint.h      : save/restore of the full simulator state (--checkpoint-at / --restore)
+ *   sampling.h        : window sizes + confidence interval math for sampled mode
+ *   pipeline.h        : multi-threaded decode / split / simulate / format engine (--pipeline)
+ *   locality.h        : reuse distance / working set / hot page analysis (-l locality)
+ *   intervalStats.h   : per-window CSV time series (--interval-stats)
+ *   cacheModel.h      : L1/L2/... data caches fed with translated physical addresses (--cache)
+ *   latencyModel.h    : memory access time / fault latency cost model (--latency)
+ *   prefetch.h        : fault-time prefetch policies (--prefetch)
+ *   frameAllocation.h : per-process frame allocation, fixed / PFF / WSClock (--alloc)
+ *   compare.h         : several configurations simulated in lockstep, with their divergences (-l compare)
+ *   scaling.h         : lock-free shared page table filled by 1..N threads, timed (-l scaling)
+ *   tune.h            : level split search on a thread pool, Pareto frontier of walk length vs bytes (-l tune)
+ *   traceSource.h     : reads the trace records, from one or more files merged by time, filtered by --proc / --reqtype / --addr-range
+ *   flightRecorder.h  : ring of recent events, dumped on a fault storm, SIGUSR1 or exit (frdecode prints dumps)
  */
 
+#include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <fstream>
+#include <getopt.h>
 #include <iostream>
-#include <pthread.h>   // (appears unused here; possibly needed elsewhere in your project)
 #include <sstream>
+#include <thread>
 #include <unistd.h>
 #include <vector>
 
+#include "cacheModel.h"
+#include "checkpoint.h"
+#include "compare.h"
+#include "flightRecorder.h"
+#include "frameAllocation.h"
+#include "intervalStats.h"
+#include "latencyModel.h"
+#include "locality.h"
 #include "log_helpers.h"
-#include "nfu.h"
 #include "pageTable.h"
+#include "pipeline.h"
+#include "prefetch.h"
+#include "sampling.h"
+#include "scaling.h"
+#include "simulation.h"
+#include "tune.h"
 #include "vaddr_tracereader.h"
 
 using namespace std;
 
+/*──────────────────────────────────────────────────────────────────────────────┐
+│ Run options + checkpoint plumbing                                            │
+└──────────────────────────────────────────────────────────────────────────────*/
+
+// Accesses decoded and decomposed per trace read
+static const size_t ACCESS_BATCH_SIZE = 256;
+
+/**
+ * Accesses still allowed by -n, or -1 when the whole trace is processed.
+ */
+static int64_t remainingAccesses(const RunOptions& opts, const SimCounters& sim) {
+    return opts.numAccesses > 0 ? max<int64_t>(opts.numAccesses - sim.count, 0) : -1;
+}
+
+/**
+ * Called after every simulated access (batch access i): counts the page
+ * toward the --interval-stats window, writes the window row at its end, and
+ * writes the checkpoint once the requested access count is reached.
+ */
+static void afterAccess(const TraceSource& source, const Simulator& simulator, const RunOptions& opts,
+                        IntervalRecorder& intervals, const AddressBatch& batch, size_t i) {
+    const PageTable& pt = simulator.pt;
+    const SimCounters& sim = simulator.counters;
+    intervals.touch(batch.vaddr[i] >> pt.offsetBits);
+    intervals.afterAccess(pt, sim);
+
+    if (sim.count == opts.checkpointAt) {
+        // records already read from the trace but not yet simulated
+        const size_t pending = batch.count - i - 1;
+        const uint64_t offset = source.position() - (uint64_t)pending * source.recordBytes();
+        saveCheckpoint(opts.checkpointFile, simulator, opts.filter, offset);
+    }
+}
+
+/**
+ * Prints the summary block for a finished run.
+ */
+static void printSummary(const Simulator& simulator) {
+    const SimulatorStats st = simulator.stats();
+
+    log_summary(st.pageSize, st.pageReplacements, st.hits, st.accesses, st.framesAllocated, st.tableEntries);
+    log_pagetable_usage(st.tableBytes, st.peakBytes, st.peakEntries);
+    log_write_backs(st.writeBacks, st.pageSize, st.pageReplacements);
+    const PageWalkCache& walkCache = simulator.pt.walkCache;
+    if (walkCache.enabled()) {
+        log_walk_cache(walkCache.walks, walkCache.resumedAt.data(), simulator.pt.numLevels);
+    }
+    const Prefetcher& prefetcher = simulator.prefetcher;
+    if (prefetcher.enabled()) {
+        log_prefetch(prefetcher.stats.issued, prefetcher.stats.used, prefetcher.stats.polluted, st.misses);
+    }
+    for (size_t level = 0; level < simulator.caches.levels.size(); level++) {
+        const CacheLevel& cache = simulator.caches.levels[level];
+        log_cache_level((int)level + 1, cache.hits, cache.misses);
+    }
+    const FrameAllocator& allocator = simulator.allocator;
+    if (allocator.enabled()) {
+        log_frame_allocation(allocPolicyName(allocator.config.policy), allocator.quotaChanges);
+        for (int proc = 0; proc < FrameAllocator::MAX_PROCS; proc++) {
+            const ProcessFrames& p = allocator.procs[proc];
+            if (p.seen) {
+                log_process_frames(proc, p.accesses, p.faults, p.quota, p.resident, p.peakResident);
+            }
+        }
+    }
+    const LatencyModel& latency = simulator.latency;
+    if (latency.enabled) {
+        log_latency_summary(latency.now, st.accesses, latency.faults.total, latency.faultTime,
+                            latency.faults.percentile(0.50), latency.faults.percentile(0.99),
+                            latency.faults.percentile(0.999));
+    }
+}
+
 /*──────────────────────────────────────────────────────────────────────────────┐
 │ Helpers per log mode                                                         │
 └──────────────────────────────────────────────────────────────────────────────*/
@@ -37,7 +140,7 @@ using namespace std;
  * bitmasks mode:
  * Print bitmasks for each page table level.
  */
-static int run_bitmasks(PageTable& pt) {
+static int run_bitmasks(const PageTable& pt) {
     log_bitmasks(pt.numLevels, pt.bitmasks.data());
     return 0;
 }
@@ -46,67 +149,35 @@ static int run_bitmasks(PageTable& pt) {
  * va2pa mode:
  * For each address, produce virtual→physical translation using the page table +
  * NFU replacement policy. Logs the final physical address for each access.
- *
- * @param numAccesses If <= 0: process entire trace; else: only first numAccesses.
  */
-static int run_va2pa(const string& traceFile, PageTable& pt, int numAccesses, int /*numFrames*/) {
-    FILE* tf = fopen(traceFile.c_str(), "rb");
-    if (!tf) {
-        cerr << "Unable to open " << traceFile << '\n';
+static int run_va2pa(const vector<string>& traceFiles, Simulator& simulator, const RunOptions& opts) {
+    const PageTable& pt = simulator.pt;
+    const SimCounters& sim = simulator.counters;
+    TraceSource source;
+    if (!openTraceForRun(traceFiles, simulator, opts, source)) {
+        return 1;
+    }
+    IntervalRecorder intervals;
+    if (!intervals.open(opts, sim)) {
         return 1;
     }
 
-    p2AddrTr mTrace{};
-    int count = 0;
-    int nextFreePFN = 0;
-
-    while ((numAccesses <= 0 || count < numAccesses) && NextAddress(tf, &mTrace)) {
-        const uint32_t vaddr = mTrace.addr;
-
-        beforeAccessNFU();
-        const uint32_t vpn = vaddr >> pt.offsetBits;
+    AddressBatch batch;
+    batch.init(pt.numLevels, ACCESS_BATCH_SIZE);
 
-        Map* mapping = pt.searchMappedPfn(vaddr);
+    while (readAddressBatch(source, pt, batch, remainingAccesses(opts, sim))) {
+        for (size_t i = 0; i < batch.count; i++) {
+            const AccessOutcome out = simulator.access(batch, i);
 
-        if (mapping && mapping->valid) {
-            // Page table hit
-            onHitNFU(vpn);
-        } else {
-            // Page table miss
-            if (!isFullNFU()) {
-                // Free frame available: install mapping
-                pt.insertMapForVpn2Pfn(vaddr, nextFreePFN);
-                onMissNFU(vpn, nextFreePFN);
-                mapping = pt.searchMappedPfn(vaddr);
-                nextFreePFN++;
-            } else {
-                // Must evict victim selected by NFU
-                const int victimIndex = selectVictimNFU();
-                const int victimPFN   = nfuState.pages[victimIndex].pfn;
-
-                // reuseSlotNFU returns (oldVPN, oldBitstring), and advances to hold 'vpn'
-                const auto oldInfo  = reuseSlotNFU(victimIndex, vpn);
-                const uint32_t oldVaddr = oldInfo.first << pt.offsetBits;
-
-                // Invalidate old mapping in the page table
-                if (Map* oldMapping = pt.searchMappedPfn(oldVaddr)) {
-                    oldMapping->valid = false;
-                }
+            // Construct physical address = (PFN << offsetBits) | offset
+            const uint64_t paddr = (uint64_t(out.mapping->pfn) << pt.offsetBits) | batch.offset[i];
+            log_va2pa(batch.vaddr[i], paddr);
 
-                // Insert the new mapping
-                pt.insertMapForVpn2Pfn(vaddr, victimPFN);
-                mapping = pt.searchMappedPfn(vaddr);
-            }
+            afterAccess(source, simulator, opts, intervals, batch, i);
         }
-
-        // Construct physical address = (PFN << offsetBits) | offset
-        const uint32_t paddr = (uint32_t(mapping->pfn) << pt.offsetBits) | pt.getOffset(vaddr);
-        log_va2pa(vaddr, paddr);
-
-        count++;
     }
 
-    fclose(tf);
+    intervals.close(pt, sim);
     return 0;
 }
 
@@ -114,62 +185,39 @@ static int run_va2pa(const string& traceFile, PageTable& pt, int numAccesses, in
  * vpns_pfn mode:
  * For each access, log the VPN pieces at each level and the PFN (if mapped).
  */
-static int run_vpns_pfn(const string& traceFile, PageTable& pt, int numAccesses, int /*numFrames*/) {
-    FILE* tf = fopen(traceFile.c_str(), "rb");
-    if (!tf) {
-        cerr << "Unable to open " << traceFile << '\n';
+static int run_vpns_pfn(const vector<string>& traceFiles, Simulator& simulator, const RunOptions& opts) {
+    const PageTable& pt = simulator.pt;
+    const SimCounters& sim = simulator.counters;
+    TraceSource source;
+    if (!openTraceForRun(traceFiles, simulator, opts, source)) {
+        return 1;
+    }
+    IntervalRecorder intervals;
+    if (!intervals.open(opts, sim)) {
         return 1;
     }
 
-    p2AddrTr mTrace{};
-    int count = 0;
-    int nextFreePFN = 0;
-
-    while ((numAccesses <= 0 || count < numAccesses) && NextAddress(tf, &mTrace)) {
-        const uint32_t vaddr = mTrace.addr;
-
-        // Extract multi-level VPN pieces
-        vector<unsigned> vpnPieces(pt.numLevels);
-        for (int i = 0; i < pt.numLevels; i++) {
-            vpnPieces[i] = pt.getVPNPiece(vaddr, i);
-        }
-
-        beforeAccessNFU();
-        const uint32_t vpn = vaddr >> pt.offsetBits;
-
-        Map* mapping = pt.searchMappedPfn(vaddr);
+    AddressBatch batch;
+    batch.init(pt.numLevels, ACCESS_BATCH_SIZE);
+    vector<uint32_t> vpnPieces(pt.numLevels); // one access's pieces, gathered for logging
 
-        if (mapping && mapping->valid) {
-            onHitNFU(vpn);
-        } else {
-            if (!isFullNFU()) {
-                pt.insertMapForVpn2Pfn(vaddr, nextFreePFN);
-                onMissNFU(vpn, nextFreePFN);
-                mapping = pt.searchMappedPfn(vaddr);
-                nextFreePFN++;
-            } else {
-                const int victimIndex = selectVictimNFU();
-                const int victimPFN   = nfuState.pages[victimIndex].pfn;
-
-                const auto oldInfo    = reuseSlotNFU(victimIndex, vpn);
-                const uint32_t oldVaddr = oldInfo.first << pt.offsetBits;
-
-                if (Map* oldMapping = pt.searchMappedPfn(oldVaddr)) {
-                    oldMapping->valid = false;
-                }
+    while (readAddressBatch(source, pt, batch, remainingAccesses(opts, sim))) {
+        for (size_t i = 0; i < batch.count; i++) {
+            const AccessOutcome out = simulator.access(batch, i);
 
-                pt.insertMapForVpn2Pfn(vaddr, victimPFN);
-                mapping = pt.searchMappedPfn(vaddr);
+            // Multi-level VPN pieces were extracted for the whole batch up front
+            for (int level = 0; level < pt.numLevels; level++) {
+                vpnPieces[level] = batch.rows[level][i];
             }
-        }
 
-        const int pfn = (mapping && mapping->valid) ? mapping->pfn : -1;
-        log_vpns_pfn(pt.numLevels, vpnPieces.data(), pfn);
+            const int pfn = (out.mapping && out.mapping->valid) ? out.mapping->pfn : -1;
+            log_vpns_pfn(pt.numLevels, vpnPieces.data(), pfn);
 
-        count++;
+            afterAccess(source, simulator, opts, intervals, batch, i);
+        }
     }
 
-    fclose(tf);
+    intervals.close(pt, sim);
     return 0;
 }
 
@@ -177,24 +225,23 @@ static int run_vpns_pfn(const string& traceFile, PageTable& pt, int numAccesses,
  * offset mode:
  * For each access, log only the page offset.
  */
-static int run_offset(const string& traceFile, PageTable& pt, int numAccesses) {
-    FILE* tf = fopen(traceFile.c_str(), "rb");
-    if (!tf) {
-        cerr << "Unable to open " << traceFile << '\n';
+static int run_offset(const vector<string>& traceFiles, const PageTable& pt, int64_t numAccesses,
+                      const TraceFilter& filter) {
+    TraceSource source;
+    if (!source.open(traceFiles, pt, filter)) {
         return 1;
     }
 
-    p2AddrTr mTrace{};
-    int count = 0;
+    p2AddrTr64 mTrace{};
+    int64_t count = 0;
 
-    while ((numAccesses <= 0 || count < numAccesses) && NextAddress(tf, &mTrace)) {
-        const uint32_t vaddr = mTrace.addr;
-        const unsigned offset = pt.getOffset(vaddr);
+    while ((numAccesses <= 0 || count < numAccesses) && source.next(&mTrace)) {
+        const uint64_t vaddr = mTrace.addr;
+        const uint64_t offset = pt.getOffset(vaddr);
         print_num_inHex(offset);
         count++;
     }
 
-    fclose(tf);
     return 0;
 }
 
@@ -204,68 +251,54 @@ static int run_offset(const string& traceFile, PageTable& pt, int numAccesses) {
  *  - page size, page replacements, hits, total addresses processed,
  *    frames allocated (first-time allocations), and number of PTEs.
  */
-static int run_summary(const string& traceFile, PageTable& pt, int numAccesses) {
-    FILE* tf = fopen(traceFile.c_str(), "rb");
-    if (!tf) {
-        cerr << "Unable to open " << traceFile << '\n';
+static int run_summary(const vector<string>& traceFiles, Simulator& simulator, const RunOptions& opts) {
+    const PageTable& pt = simulator.pt;
+    const SimCounters& sim = simulator.counters;
+    TraceSource source;
+    if (!openTraceForRun(traceFiles, simulator, opts, source)) {
+        return 1;
+    }
+    IntervalRecorder intervals;
+    if (!intervals.open(opts, sim)) {
         return 1;
     }
 
-    p2AddrTr mTrace{};
-    int count = 0;
-    int nextFreePFN = 0;
-
-    const unsigned pageSize          = pt.pageSizeBytes();
-    unsigned addressesProcessed      = 0;
-    unsigned hits                    = 0;
-    unsigned pageReplacements        = 0;
-    unsigned framesAllocated         = 0;
-    unsigned numEntries              = 0;
-
-    while ((numAccesses <= 0 || count < numAccesses) && NextAddress(tf, &mTrace)) {
-        const uint32_t vaddr = mTrace.addr;
-
-        beforeAccessNFU();
-        const uint32_t vpn   = vaddr >> pt.offsetBits;
-
-        Map* mapping = pt.searchMappedPfn(vaddr);
+    AddressBatch batch;
+    batch.init(pt.numLevels, ACCESS_BATCH_SIZE);
 
-        if (mapping && mapping->valid) {
-            hits++;
-            onHitNFU(vpn);
-        } else {
-            if (!isFullNFU()) {
-                framesAllocated++;
-                pt.insertMapForVpn2Pfn(vaddr, nextFreePFN);
-                onMissNFU(vpn, nextFreePFN);
-                mapping = pt.searchMappedPfn(vaddr);
-                nextFreePFN++;
-            } else {
-                pageReplacements++;
-                const int victimIndex = selectVictimNFU();
-                const int victimPFN   = nfuState.pages[victimIndex].pfn;
-
-                const auto oldInfo    = reuseSlotNFU(victimIndex, vpn);
-                const uint32_t oldVaddr = oldInfo.first << pt.offsetBits;
-
-                if (Map* oldMapping = pt.searchMappedPfn(oldVaddr)) {
-                    oldMapping->valid = false;
-                }
+    while (readAddressBatch(source, pt, batch, remainingAccesses(opts, sim))) {
+        for (size_t i = 0; i < batch.count; i++) {
+            simulator.access(batch, i);
+            afterAccess(source, simulator, opts, intervals, batch, i);
 
-                pt.insertMapForVpn2Pfn(vaddr, victimPFN);
-                mapping = pt.searchMappedPfn(vaddr);
+            // Nothing is logged per access, so a run of accesses to the same page is
+            // simulated in one step (stopping at the checkpoint access or window end, if
+            // any). The cache model needs every address, so it turns this off.
+            if (simulator.caches.enabled()) {
+                continue;
+            }
+            int64_t untilStop = intervals.untilBoundary(sim);
+            if (opts.checkpointAt > sim.count) {
+                untilStop = min(untilStop, opts.checkpointAt - sim.count);
+            }
+            size_t end = batch.count;
+            if (untilStop < (int64_t)(end - i - 1)) {
+                end = i + 1 + (size_t)untilStop;
+            }
+            const size_t repeats = sameVpnRun(pt, batch, i + 1, end);
+            if (repeats > 0) {
+                const auto first = batch.write.begin() + (ptrdiff_t)(i + 1);
+                const auto last  = first + (ptrdiff_t)repeats;
+                simulator.repeatHits(repeats, find(first, last, 1) != last, batch.proc[i]);
+                i += repeats;
+                afterAccess(source, simulator, opts, intervals, batch, i);
             }
         }
-
-        count++;
     }
 
-    addressesProcessed = count;
-    numEntries         = pt.countEntries(&pt);
-
-    log_summary(pageSize, pageReplacements, hits, addressesProcessed, framesAllocated, numEntries);
+    intervals.close(pt, sim);
+    printSummary(simulator);
 
-    fclose(tf);
     return 0;
 }
 
@@ -274,64 +307,141 @@ static int run_summary(const string& traceFile, PageTable& pt, int numAccesses)
  * For each access, log the (vpn, pfn) mapping, whether it was a page-table hit,
  * and when replacement occurs also log victim vpn and its NFU bitstring.
  */
-static int run_vpn2pfn_pr(const string& traceFile, PageTable& pt, int numAccesses) {
-    FILE* tf = fopen(traceFile.c_str(), "rb");
-    if (!tf) {
-        cerr << "Unable to open " << traceFile << '\n';
+static int run_vpn2pfn_pr(const vector<string>& traceFiles, Simulator& simulator, const RunOptions& opts) {
+    const PageTable& pt = simulator.pt;
+    const SimCounters& sim = simulator.counters;
+    TraceSource source;
+    if (!openTraceForRun(traceFiles, simulator, opts, source)) {
+        return 1;
+    }
+    IntervalRecorder intervals;
+    if (!intervals.open(opts, sim)) {
         return 1;
     }
 
-    p2AddrTr mTrace{};
-    int count = 0;
-    int nextFreePFN = 0;
+    AddressBatch batch;
+    batch.init(pt.numLevels, ACCESS_BATCH_SIZE);
 
-    while ((numAccesses <= 0 || count < numAccesses) && NextAddress(tf, &mTrace)) {
-        const uint32_t vaddr = mTrace.addr;
+    while (readAddressBatch(source, pt, batch, remainingAccesses(opts, sim))) {
+        for (size_t i = 0; i < batch.count; i++) {
+            const uint64_t vpn = batch.vaddr[i] >> pt.offsetBits;
+            const AccessOutcome out = simulator.access(batch, i);
 
-        bool pthit           = false;
-        int  vpnReplaced     = -1;
-        int  victimBitstring = 0;
+            const int pfn = (out.mapping && out.mapping->valid) ? out.mapping->pfn : -1;
+            log_mapping(vpn, pfn, out.vpnReplaced, out.victimBitstring, out.pthit);
 
-        beforeAccessNFU();
-        const uint32_t vpn = vaddr >> pt.offsetBits;
+            afterAccess(source, simulator, opts, intervals, batch, i);
+        }
+    }
 
-        Map* mapping = pt.searchMappedPfn(vaddr);
+    intervals.close(pt, sim);
+    return 0;
+}
 
-        if (mapping && mapping->valid) {
-            pthit = true;
-            onHitNFU(vpn);
-        } else {
-            if (!isFullNFU()) {
-                pt.insertMapForVpn2Pfn(vaddr, nextFreePFN);
-                onMissNFU(vpn, nextFreePFN);
-                mapping = pt.searchMappedPfn(vaddr);
-                nextFreePFN++;
-            } else {
-                const int victimIndex = selectVictimNFU();
-                const int victimPFN   = nfuState.pages[victimIndex].pfn;
-
-                vpnReplaced     = nfuState.pages[victimIndex].vpn;
-                victimBitstring = nfuState.pages[victimIndex].bitstring;
-
-                const auto oldInfo    = reuseSlotNFU(victimIndex, vpn);
-                const uint32_t oldVaddr = oldInfo.first << pt.offsetBits;
-
-                if (Map* oldMapping = pt.searchMappedPfn(oldVaddr)) {
-                    oldMapping->valid = false;
-                }
+/**
+ * sampled mode:
+ * SimPoint-style sampling. Repeats fast-forward / warm-up / measure windows
+ * over the trace; only measure windows feed the statistics, which are then
+ * extrapolated to the whole trace with 95% confidence intervals.
+ *
+ * Fast-forward keeps page table and NFU state functionally up to date (warmAccess,
+ * which skips the caches, latency model and other statistics), or with
+ * --sample-seek jumps over the records (fixed-size records make the trace its
+ * own index), relying on warm-up to repopulate state.
+ */
+static int run_sampled(const vector<string>& traceFiles, Simulator& simulator, const RunOptions& opts,
+                       const SampleWindows& windows) {
+    const PageTable& pt = simulator.pt;
+    TraceSource source;
+    if (!source.open(traceFiles, pt, opts.filter)) {
+        return 1;
+    }
 
-                pt.insertMapForVpn2Pfn(vaddr, victimPFN);
-                mapping = pt.searchMappedPfn(vaddr);
+    // Total accesses the estimate covers: the whole (filtered) trace, capped by -n
+    int64_t totalAccesses = (int64_t)source.totalRecords();
+    if (opts.numAccesses > 0 && opts.numAccesses < totalAccesses) {
+        totalAccesses = opts.numAccesses;
+    }
+
+    const SimCounters& sim = simulator.counters;
+    SampleStats hitStats;
+    SampleStats replaceStats;
+    p2AddrTr64 mTrace{};
+    int64_t consumed = 0;          // trace records read or seeked over
+    uint64_t measuredAccesses = 0;
+
+    while (consumed < totalAccesses) {
+        // Fast-forward
+        const int64_t skip = min(windows.fastForward, totalAccesses - consumed);
+        if (windows.seek) {
+            consumed += (int64_t)source.skip((uint64_t)skip);
+        } else {
+            for (int64_t i = 0; i < skip && source.next(&mTrace); i++, consumed++) {
+                simulator.warmAccess(mTrace.addr, isWriteRecord(mTrace), mTrace.proc);
             }
         }
 
-        const int pfn = (mapping && mapping->valid) ? mapping->pfn : -1;
-        log_mapping(vpn, pfn, vpnReplaced, victimBitstring, pthit);
+        // Warm-up
+        const int64_t warm = min(windows.warmup, totalAccesses - consumed);
+        for (int64_t i = 0; i < warm && source.next(&mTrace); i++, consumed++) {
+            simulator.access(mTrace.addr, isWriteRecord(mTrace), mTrace.proc);
+        }
+
+        // Measure
+        const SimCounters before = sim;
+        const int64_t measure = min(windows.measure, totalAccesses - consumed);
+        for (int64_t i = 0; i < measure && source.next(&mTrace); i++, consumed++) {
+            simulator.access(mTrace.addr, isWriteRecord(mTrace), mTrace.proc);
+        }
 
-        count++;
+        const int64_t measured = sim.count - before.count;
+        if (measured > 0) {
+            hitStats.add(100.0 * (double)(sim.hits - before.hits) / (double)measured);
+            replaceStats.add(100.0 * (double)(sim.pageReplacements - before.pageReplacements) / (double)measured);
+            measuredAccesses += measured;
+        }
+        if (measured < measure) {
+            break; // trace ended early
+        }
     }
 
-    fclose(tf);
+    log_sampled_summary(pt.pageSizeBytes(), hitStats.n, measuredAccesses, totalAccesses,
+                        hitStats.mean, hitStats.halfWidth95(),
+                        replaceStats.mean, replaceStats.halfWidth95());
+
+    return 0;
+}
+
+/**
+ * locality mode:
+ * Characterizes the page reference stream itself, without simulating frames:
+ * reuse distance histogram, working set size W(t, tau) and the hottest pages,
+ * all gathered in one pass and printed as CSV.
+ */
+static int run_locality(const vector<string>& traceFiles, const PageTable& pt, int64_t numAccesses,
+                        const TraceFilter& filter, const LocalityOptions& localityOpts) {
+    TraceSource source;
+    if (!source.open(traceFiles, pt, filter)) {
+        return 1;
+    }
+
+    LocalityAnalyzer analyzer;
+    analyzer.init(localityOpts);
+
+    AddressBatch batch;
+    batch.init(pt.numLevels, ACCESS_BATCH_SIZE);
+    int64_t count = 0;
+
+    while (readAddressBatch(source, pt, batch, numAccesses > 0 ? numAccesses - count : -1)) {
+        for (size_t i = 0; i < batch.count; i++) {
+            analyzer.access(batch.vaddr[i] >> pt.offsetBits);
+        }
+        count += (int64_t)batch.count;
+    }
+    analyzer.finish();
+
+    printLocalityCsv(analyzer, pt);
+
     return 0;
 }
 
@@ -339,20 +449,130 @@ static int run_vpn2pfn_pr(const string& traceFile, PageTable& pt, int numAccesse
 │ main                                                                          │
 └──────────────────────────────────────────────────────────────────────────────*/
 
+// Long-only options (no short equivalent), numbered past the ASCII range
+enum LongOption {
+    OPT_CHECKPOINT_AT = 256,
+    OPT_CHECKPOINT_FILE,
+    OPT_RESTORE,
+    OPT_SAMPLE,
+    OPT_SAMPLE_SEEK,
+    OPT_PIPELINE,
+    OPT_WS_TAU,
+    OPT_TOP_K,
+    OPT_INTERVAL_STATS,
+    OPT_INTERVAL_FILE,
+    OPT_COMPARE,
+    OPT_CACHE,
+    OPT_LATENCY,
+    OPT_WALK_CACHE,
+    OPT_PREFETCH,
+    OPT_CLEAN_FIRST,
+    OPT_ALLOC,
+    OPT_QUOTA_FILE,
+    OPT_THREADS,
+    OPT_SPARSE_LEVELS,
+    OPT_MAX_DEPTH,
+    OPT_WALK_BUDGET,
+    OPT_FLIGHT_EVENTS,
+    OPT_FLIGHT_FILE,
+    OPT_FLIGHT_TRIGGER,
+    OPT_FLIGHT_AT_EXIT,
+    OPT_PROC,
+    OPT_REQTYPE,
+    OPT_ADDR_RANGE,
+};
+
+// True for an argument made only of digits, which starts the level bit
+// list instead of naming another trace file
+static bool isLevelBitsArg(const char* arg) {
+    if (*arg == '\0') return false;
+    for (; *arg; arg++) {
+        if (!isdigit((unsigned char)*arg)) return false;
+    }
+    return true;
+}
+
+static void printUsage(const char* prog) {
+    cerr << "Usage: " << prog
+         << " [-n numAccesses] [-f availFrames] [-b bitUpdateInterval] [-l logMode] [-t radix|inverted] [-r] [-a addressBits]"
+         << " [--checkpoint-at N --checkpoint-file F] [--restore F] [--sample FF,WARM,MEASURE [--sample-seek]] [--pipeline]"
+         << " [--ws-tau N] [--top-k K] [--interval-stats N [--interval-file F]] [--compare SPEC...] [--cache SIZE:WAYS:LINE[:POLICY]...] [--latency[=SPEC]] [--pwc N[,N...]] [--prefetch next:N|stride:N|adaptive:MAX] [--clean-first[=TOL]] [--alloc fixed:Q|pff:LOW:HIGH|wsclock:TAU [--quota-file F]] [--threads N] [--sparse-levels[=FILL]] [--max-depth D] [--walk-budget W]"
+         << " [--flight-events N] [--flight-file F] [--flight-trigger FAULTS:WINDOW] [--flight-at-exit]"
+         << " [--proc P[,P...]] [--reqtype T[,T...]] [--addr-range LO:HI]"
+         << " trace.tr [more traces...] <levelBits...>" << endl;
+}
+
 int main(int argc, char** argv) {
     int opt               = 0;
-    int numAccesses       = -1;       // If not specified: process all accesses
     int availFrames       = 999999;   // Total NFU capacity (simulated free frames)
     int bitUpdateInterval = 10;       // NFU age/bitstring update period (in accesses)
     string logMode        = "summary";
+    string tableType      = "radix";  // Page table backend: radix (Level tree) or inverted
+    bool reclaimLevels    = false;    // Free page table levels left without valid mappings
+    int sparseFill        = 0;        // --sparse-levels: percent fill up to which interior levels stay bitmap-compressed
+    int addressBits       = 32;       // Virtual address width; above 32 the trace holds p2AddrTr64 records
+    RunOptions runOpts;               // -n, checkpoint and trace filter settings for the simulating modes
+    SampleWindows sampleWindows;      // Window sizes for -l sampled
+    bool pipelined        = false;    // Run va2pa/vpns_pfn/vpn2pfn_pr/summary on the multi-threaded pipeline
+    LocalityOptions localityOpts;     // Working set window and hot page count for -l locality
+    vector<string> compareSpecs;      // One per --compare: the configurations -l compare runs side by side
+    vector<CacheLevelConfig> caches;  // One per --cache, L1 first: data cache model behind translation
+    vector<unsigned> walkCache;       // --pwc entries per depth, for the page walk cache
+    PrefetchConfig prefetch;          // --prefetch policy
+    int cleanTolerance    = -1;       // --clean-first: bitstring distance within which NFU evicts a clean page first
+    AllocConfig alloc;                // --alloc: per-process frame allocation policy
+    string quotaFile;                 // --quota-file: CSV of every per-process quota change
+    int threadCount       = (int)max(1u, min(thread::hardware_concurrency(), (unsigned)MAX_SCALING_THREADS)); // --threads: most threads -l scaling runs, -l tune's pool size
+    TuneOptions tuneOpts;             // --max-depth and --walk-budget for -l tune
+    int64_t flightEvents  = 65536;    // --flight-events: flight recorder ring size, 0 turns it off
+    string flightFile     = "flight.pgfr"; // --flight-file: where flight recorder dumps go
+    uint64_t flightFaults = 0;        // --flight-trigger: dump once FAULTS faults happen within WINDOW accesses
+    uint64_t flightWindow = 0;
+    bool flightAtExit     = false;    // --flight-at-exit: dump when the run ends
+    bool latencyModel     = false;    // Accumulate memory access time and fault latencies (--latency)
+    LatencyConfig latency;            // Costs for --latency
     vector<int> levelBits;
 
-    // Parse optional flags: -n (numAccesses), -f (frames), -b (bit interval), -l (log mode)
-    while ((opt = getopt(argc, argv, "n:f:b:l:")) != -1) {
+    static const struct option longOptions[] = {
+        {"checkpoint-at",   required_argument, nullptr, OPT_CHECKPOINT_AT},
+        {"checkpoint-file", required_argument, nullptr, OPT_CHECKPOINT_FILE},
+        {"restore",         required_argument, nullptr, OPT_RESTORE},
+        {"sample",          required_argument, nullptr, OPT_SAMPLE},
+        {"sample-seek",     no_argument,       nullptr, OPT_SAMPLE_SEEK},
+        {"pipeline",        no_argument,       nullptr, OPT_PIPELINE},
+        {"ws-tau",          required_argument, nullptr, OPT_WS_TAU},
+        {"top-k",           required_argument, nullptr, OPT_TOP_K},
+        {"interval-stats",  required_argument, nullptr, OPT_INTERVAL_STATS},
+        {"interval-file",   required_argument, nullptr, OPT_INTERVAL_FILE},
+        {"compare",         required_argument, nullptr, OPT_COMPARE},
+        {"cache",           required_argument, nullptr, OPT_CACHE},
+        {"latency",         optional_argument, nullptr, OPT_LATENCY},
+        {"pwc",             required_argument, nullptr, OPT_WALK_CACHE},
+        {"prefetch",        required_argument, nullptr, OPT_PREFETCH},
+        {"clean-first",     optional_argument, nullptr, OPT_CLEAN_FIRST},
+        {"alloc",           required_argument, nullptr, OPT_ALLOC},
+        {"quota-file",      required_argument, nullptr, OPT_QUOTA_FILE},
+        {"threads",         required_argument, nullptr, OPT_THREADS},
+        {"sparse-levels",   optional_argument, nullptr, OPT_SPARSE_LEVELS},
+        {"max-depth",       required_argument, nullptr, OPT_MAX_DEPTH},
+        {"walk-budget",     required_argument, nullptr, OPT_WALK_BUDGET},
+        {"flight-events",   required_argument, nullptr, OPT_FLIGHT_EVENTS},
+        {"flight-file",     required_argument, nullptr, OPT_FLIGHT_FILE},
+        {"flight-trigger",  required_argument, nullptr, OPT_FLIGHT_TRIGGER},
+        {"flight-at-exit",  no_argument,       nullptr, OPT_FLIGHT_AT_EXIT},
+        {"proc",            required_argument, nullptr, OPT_PROC},
+        {"reqtype",         required_argument, nullptr, OPT_REQTYPE},
+        {"addr-range",      required_argument, nullptr, OPT_ADDR_RANGE},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    // Parse optional flags: -n (numAccesses), -f (frames), -b (bit interval), -l (log mode), -t (table backend), -r (reclaim),
+    // -a (address bits), plus the long options above
+    while ((opt = getopt_long(argc, argv, "n:f:b:l:t:ra:", longOptions, nullptr)) != -1) {
         switch (opt) {
             case 'n':
-                numAccesses = atoi(optarg);
-                if (numAccesses < 1) {
+                runOpts.numAccesses = atoll(optarg);
+                if (runOpts.numAccesses < 1) {
                     cerr << "Number of memory accesses must be a number and greater than 0" << endl;
                     exit(0);
                 }
@@ -374,29 +594,243 @@ int main(int argc, char** argv) {
             case 'l':
                 logMode = optarg;
                 break;
+            case 't':
+                tableType = optarg;
+                if (tableType != "radix" && tableType != "inverted") {
+                    cerr << "Page table type must be radix or inverted" << endl;
+                    exit(0);
+                }
+                break;
+            case 'r':
+                reclaimLevels = true;
+                break;
+            case 'a':
+                addressBits = atoi(optarg);
+                if (addressBits < 32 || addressBits > 64) {
+                    cerr << "Address bits must be between 32 and 64" << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_CHECKPOINT_AT:
+                runOpts.checkpointAt = atoll(optarg);
+                if (runOpts.checkpointAt < 1) {
+                    cerr << "Checkpoint access count must be a number and greater than 0" << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_CHECKPOINT_FILE:
+                runOpts.checkpointFile = optarg;
+                break;
+            case OPT_RESTORE:
+                runOpts.restoreFile = optarg;
+                break;
+            case OPT_SAMPLE:
+                if (!parseSampleWindows(optarg, sampleWindows)) {
+                    cerr << "Sample windows must be FF,WARM,MEASURE with MEASURE greater than 0" << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_SAMPLE_SEEK:
+                sampleWindows.seek = true;
+                break;
+            case OPT_PIPELINE:
+                pipelined = true;
+                break;
+            case OPT_WS_TAU:
+                if (atoll(optarg) < 1) {
+                    cerr << "Working set window must be a number and greater than 0" << endl;
+                    exit(0);
+                }
+                localityOpts.tau = (uint64_t)atoll(optarg);
+                break;
+            case OPT_TOP_K:
+                if (atoi(optarg) < 0) {
+                    cerr << "Number of hot pages must be a number and at least 0" << endl;
+                    exit(0);
+                }
+                localityOpts.topK = (size_t)atoi(optarg);
+                break;
+            case OPT_INTERVAL_STATS:
+                runOpts.intervalStats = atoll(optarg);
+                if (runOpts.intervalStats < 1) {
+                    cerr << "Interval stats window must be a number and greater than 0" << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_INTERVAL_FILE:
+                runOpts.intervalFile = optarg;
+                break;
+            case OPT_COMPARE: {
+                SimulatorConfig check;
+                if (!parseCompareSpec(optarg, check)) {
+                    cerr << "Compare spec must be comma separated f=FRAMES, b=INTERVAL, t=radix|inverted, r, c=TOL, a=ALLOC or s=FILL" << endl;
+                    exit(0);
+                }
+                compareSpecs.push_back(optarg);
+                break;
+            }
+            case OPT_CACHE: {
+                CacheLevelConfig cache;
+                if (!parseCacheSpec(optarg, cache)) {
+                    cerr << "Cache spec must be SIZE:WAYS:LINE[:lru|fifo|random] with a power of two set count and line size" << endl;
+                    exit(0);
+                }
+                caches.push_back(cache);
+                break;
+            }
+            case OPT_WALK_CACHE:
+                if (!parseWalkCacheSpec(optarg, walkCache)) {
+                    cerr << "Page walk cache spec must be entries per depth, e.g. 16,16,32" << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_PREFETCH:
+                if (!parsePrefetchSpec(optarg, prefetch)) {
+                    cerr << "Prefetch must be next:N, stride:N or adaptive:MAX with 1 to 1024 pages" << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_CLEAN_FIRST: {
+                const string tolerance = optarg ? optarg : "0";
+                cleanTolerance = atoi(tolerance.c_str());
+                if (tolerance.empty() || tolerance.size() > 5 ||
+                    tolerance.find_first_not_of("0123456789") != string::npos || cleanTolerance > 0xFFFF) {
+                    cerr << "Clean-first tolerance must be a bitstring distance from 0 to 65535" << endl;
+                    exit(0);
+                }
+                break;
+            }
+            case OPT_ALLOC:
+                if (!parseAllocSpec(optarg, alloc)) {
+                    cerr << "Frame allocation must be fixed:QUOTA, pff:LOW:HIGH (LOW <= HIGH) or wsclock:TAU" << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_QUOTA_FILE:
+                quotaFile = optarg;
+                break;
+            case OPT_SPARSE_LEVELS:
+                sparseFill = optarg ? atoi(optarg) : 25;
+                if (sparseFill < 1 || sparseFill > 100) {
+                    cerr << "Sparse level fill must be a percentage from 1 to 100" << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_MAX_DEPTH:
+                tuneOpts.maxDepth = atoi(optarg);
+                if (tuneOpts.maxDepth < 1 || tuneOpts.maxDepth > MAX_TUNE_DEPTH) {
+                    cerr << "Max depth must be between 1 and " << MAX_TUNE_DEPTH << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_WALK_BUDGET: {
+                char* end = nullptr;
+                tuneOpts.walkBudget = strtod(optarg, &end);
+                if (end == optarg || *end != '\0' || tuneOpts.walkBudget < 0) {
+                    cerr << "Walk budget must be a non-negative number of table levels per access" << endl;
+                    exit(0);
+                }
+                break;
+            }
+            case OPT_FLIGHT_EVENTS:
+                flightEvents = atoll(optarg);
+                if (flightEvents < 0 || flightEvents > (1ll << 30)) {
+                    cerr << "Flight recorder events must be between 0 and " << (1ll << 30) << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_FLIGHT_FILE:
+                flightFile = optarg;
+                break;
+            case OPT_FLIGHT_TRIGGER:
+                if (!parseFlightTrigger(optarg, flightFaults, flightWindow)) {
+                    cerr << "Flight trigger must be FAULTS:WINDOW with 0 < FAULTS <= WINDOW" << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_FLIGHT_AT_EXIT:
+                flightAtExit = true;
+                break;
+            case OPT_PROC:
+                if (!parseProcFilter(optarg, runOpts.filter)) {
+                    cerr << "Proc filter must be a list of procs 0..255, e.g. 0,3" << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_REQTYPE:
+                if (!parseReqtypeFilter(optarg, runOpts.filter)) {
+                    cerr << "Request type filter must be a list of fetch, read, readinv, write, ioread, iowrite,"
+                         << " data, io or reqtype numbers" << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_ADDR_RANGE:
+                if (!parseAddrRange(optarg, runOpts.filter)) {
+                    cerr << "Address range must be LO:HI in hex with LO < HI" << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_THREADS:
+                threadCount = atoi(optarg);
+                if (threadCount < 1 || threadCount > MAX_SCALING_THREADS) {
+                    cerr << "Threads must be between 1 and " << MAX_SCALING_THREADS << endl;
+                    exit(0);
+                }
+                break;
+            case OPT_LATENCY:
+                latencyModel = true;
+                if (optarg && !parseLatencySpec(optarg, latency)) {
+                    cerr << "Latency spec must be comma separated key=ns among tlb, walk, mem, minor, major, io, and qd=1..1024" << endl;
+                    exit(0);
+                }
+                break;
             default:
-                cerr << "Usage: " << argv[0]
-                     << " [-n numAccesses] [-f availFrames] [-b bitUpdateInterval] [-l logMode] trace.tr <levelBits...>" << endl;
+                printUsage(argv[0]);
                 exit(0);
         }
     }
 
-    // Required positional args: trace file, then list of level bit widths
+    // Required positional args: trace file(s), then list of level bit widths
     if (optind >= argc) {
-        cerr << "Usage: " << argv[0]
-             << " [-n numAccesses] [-f availFrames] [-b bitUpdateInterval] [-l logMode] trace.tr <levelBits...>" << endl;
+        printUsage(argv[0]);
         exit(0);
     }
 
-    const string traceFile = argv[optind++];
+    if ((runOpts.checkpointAt > 0) != !runOpts.checkpointFile.empty()) {
+        cerr << "--checkpoint-at and --checkpoint-file must be given together" << endl;
+        exit(0);
+    }
 
-    // Verify the trace file can be opened (for erroring out early)
-    ifstream infile(traceFile);
-    if (!infile.is_open() || infile.fail()) {
-        cerr << "Unable to open " << traceFile << endl;
+    if (!quotaFile.empty() && alloc.policy == AllocPolicy::Global) {
+        cerr << "--quota-file needs --alloc" << endl;
         exit(0);
     }
 
+    if (pipelined && runOpts.intervalStats > 0 && runOpts.intervalFile.empty()) {
+        cerr << "--interval-stats with --pipeline needs --interval-file" << endl;
+        exit(0);
+    }
+
+    // Every positional argument before the first number is a trace file; several
+    // traces (e.g. one per CPU) are merged into one stream ordered by time
+    vector<string> traceFiles;
+    while (optind < argc && !isLevelBitsArg(argv[optind])) {
+        traceFiles.push_back(argv[optind++]);
+    }
+    if (traceFiles.empty()) {
+        printUsage(argv[0]);
+        exit(0);
+    }
+
+    // Verify the trace files can be opened (for erroring out early)
+    for (const string& traceFile : traceFiles) {
+        ifstream infile(traceFile);
+        if (!infile.is_open() || infile.fail()) {
+            cerr << "Unable to open " << traceFile << endl;
+            exit(0);
+        }
+    }
+
     // Read level bit widths
     int totalBits = 0;
     for (int i = optind, level = 0; i < argc; i++, level++) {
@@ -405,35 +839,121 @@ int main(int argc, char** argv) {
             cerr << "Level " << level << " page table must be at least 1 bit" << endl;
             exit(0);
         }
+        if (bits > 30) {
+            cerr << "Level " << level << " page table must be at most 30 bits" << endl;
+            exit(0);
+        }
         totalBits += bits;
         levelBits.push_back(bits);
     }
 
-    // Sanity: total VPN bits must not exceed 28 (leaves at least offset bits)
-    if (totalBits > 28) {
+    // -l tune cuts the list to each candidate's depth
+    if (walkCache.size() >= levelBits.size() && logMode != "tune") {
+        cerr << "Page walk cache covers depths 1 to " << levelBits.size() - 1 << " only" << endl;
+        exit(0);
+    }
+
+    // Sanity: total VPN bits must leave at least 4 offset bits (28 for 32-bit addresses)
+    if (totalBits > addressBits - 4) {
         cerr << "Too many bits used in page tables" << endl;
         exit(0);
     }
 
     // Initialize page table and NFU system
-    PageTable pt;
-    pt.initFromLevelBits(levelBits);
+    SimulatorConfig config;
+    config.levelBits         = levelBits;
+    config.addressBits       = (unsigned)addressBits;
+    config.frames            = availFrames;
+    config.bitUpdateInterval = bitUpdateInterval;
+    config.inverted          = (tableType == "inverted");
+    config.reclaimLevels     = reclaimLevels;
+    config.sparseFill        = sparseFill;
+    config.caches            = caches;
+    config.walkCache         = walkCache;
+    config.prefetch          = prefetch;
+    config.cleanTolerance    = cleanTolerance;
+    config.alloc             = alloc;
+    config.latencyModel      = latencyModel;
+    config.latency           = latency;
+
+    Simulator simulator;
+    simulator.init(config);
+    const PageTable& pt = simulator.pt;
+    if (!quotaFile.empty() && !simulator.allocator.openLog(quotaFile)) {
+        return 1;
+    }
+    if (flightEvents > 0) {
+        simulator.enableFlightRecorder((uint64_t)flightEvents, flightFile);
+        simulator.recorder.triggerFaults = flightFaults;
+        simulator.recorder.triggerWindow = flightWindow;
+        simulator.recorder.dumpAtExit = flightAtExit;
+        installFlightSignal();
+    } else if (flightFaults > 0 || flightAtExit) {
+        cerr << "--flight-trigger and --flight-at-exit need --flight-events above 0" << endl;
+        return 1;
+    }
 
-    initNFUState(availFrames, bitUpdateInterval);
+    // Pipelined engine covers the modes that simulate every access
+    if (pipelined) {
+        PipelineOutput output = PipelineOutput::None;
+        if (logMode == "va2pa") {
+            output = PipelineOutput::Va2pa;
+        } else if (logMode == "vpns_pfn") {
+            output = PipelineOutput::VpnsPfn;
+        } else if (logMode == "vpn2pfn_pr") {
+            output = PipelineOutput::Vpn2pfnPr;
+        } else if (logMode != "summary") {
+            cerr << "--pipeline supports va2pa, vpns_pfn, vpn2pfn_pr and summary" << endl;
+            return 1;
+        }
+
+        const int rc = runPipelined(traceFiles, simulator, runOpts, output);
+        if (rc == 0 && logMode == "summary") {
+            printSummary(simulator);
+        }
+        return rc;
+    }
 
     // Dispatch selected log mode
     if (logMode == "bitmasks") {
         return run_bitmasks(pt);
     } else if (logMode == "va2pa") {
-        return run_va2pa(traceFile, pt, numAccesses, availFrames);
+        return run_va2pa(traceFiles, simulator, runOpts);
     } else if (logMode == "vpns_pfn") {
-        return run_vpns_pfn(traceFile, pt, numAccesses, availFrames);
+        return run_vpns_pfn(traceFiles, simulator, runOpts);
     } else if (logMode == "offset") {
-        return run_offset(traceFile, pt, numAccesses);
+        return run_offset(traceFiles, pt, runOpts.numAccesses, runOpts.filter);
     } else if (logMode == "summary") {
-        return run_summary(traceFile, pt, numAccesses);
+        return run_summary(traceFiles, simulator, runOpts);
     } else if (logMode == "vpn2pfn_pr") {
-        return run_vpn2pfn_pr(traceFile, pt, numAccesses);
+        return run_vpn2pfn_pr(traceFiles, simulator, runOpts);
+    } else if (logMode == "sampled") {
+        if (sampleWindows.measure == 0) {
+            cerr << "sampled mode needs --sample FF,WARM,MEASURE" << endl;
+            return 1;
+        }
+        return run_sampled(traceFiles, simulator, runOpts, sampleWindows);
+    } else if (logMode == "locality") {
+        return run_locality(traceFiles, pt, runOpts.numAccesses, runOpts.filter, localityOpts);
+    } else if (logMode == "compare") {
+        if (compareSpecs.size() < 2) {
+            cerr << "compare mode needs at least two --compare specs" << endl;
+            return 1;
+        }
+        return runCompare(traceFiles, config, compareSpecs, runOpts.numAccesses, runOpts.filter);
+    } else if (logMode == "scaling") {
+        if (config.inverted) {
+            cerr << "scaling mode needs the radix page table" << endl;
+            return 1;
+        }
+        return runScaling(traceFiles, pt, runOpts.numAccesses, runOpts.filter, threadCount);
+    } else if (logMode == "tune") {
+        if (config.inverted) {
+            cerr << "tune mode needs the radix page table" << endl;
+            return 1;
+        }
+        tuneOpts.threads = threadCount;
+        return runTune(traceFiles, config, runOpts.numAccesses, runOpts.filter, tuneOpts);
     }
 
     // Unknown mode: treat as no-op success
@@ -1,4 +1,5 @@
 #include "nfu.h"
+#include <algorithm>
 #include <iostream>
 #include <cstdint>
 #include <utility>
@@ -6,9 +7,6 @@
 #include <unordered_map>
 #include <vector>
 
-// Global NFU state object (defined in nfu.h)
-NFUState nfuState;
-
 using namespace std;
 
 /*───────────────────────────────────────────────────────────────────────────────
@@ -21,7 +19,7 @@ using namespace std;
   Notes:
   * 0x8000 == 0b1000'0000'0000'0000 (MSB for a 16-bit value).
 ───────────────────────────────────────────────────────────────────────────────*/
-static void tickNFU() {
+static void tickNFU(NFUState& nfuState) {
     for (auto& page : nfuState.pages) {
         // Shift right by one to age the usage history
         uint16_t s = static_cast<uint16_t>(page.bitstring >> 1);
@@ -37,15 +35,17 @@ static void tickNFU() {
     // Prepare for the next interval
     nfuState.accessed.clear();
     nfuState.timeSinceTick = 0;
+    nfuState.ticks++;
 }
 
 /*───────────────────────────────────────────────────────────────────────────────
   Initialize NFU state.
 
+  @param nfuState        State to reset.
   @param numFrames       Maximum number of frames NFU can hold (capacity).
   @param updateInterval  Number of accesses per "tick" of the bit aging.
 ───────────────────────────────────────────────────────────────────────────────*/
-void initNFUState(int numFrames, int updateInterval) {
+void initNFUState(NFUState& nfuState, int numFrames, int updateInterval) {
     nfuState = NFUState{};          // reset all fields
     nfuState.maxFrames     = numFrames;
     nfuState.interval      = updateInterval;
@@ -59,12 +59,12 @@ void initNFUState(int numFrames, int updateInterval) {
   - Advances virtual time counters.
   - Triggers a tick (bit aging) if we've reached the interval length.
 ───────────────────────────────────────────────────────────────────────────────*/
-void beforeAccessNFU() {
+void beforeAccessNFU(NFUState& nfuState) {
     nfuState.currentTime++;
     nfuState.timeSinceTick++;
 
     if (nfuState.timeSinceTick >= nfuState.interval) {
-        tickNFU();
+        tickNFU(nfuState);
     }
 }
 
@@ -75,10 +75,12 @@ void beforeAccessNFU() {
   - Marks the page as accessed in this interval (except exactly on tick boundary).
 
   @param vpn  Virtual page number that just hit.
+
+  @return index of the page in nfuState.pages (pages.size() if unknown).
 ───────────────────────────────────────────────────────────────────────────────*/
-void onHitNFU(uint32_t vpn) {
+size_t onHitNFU(NFUState& nfuState, uint64_t vpn) {
     auto it = nfuState.vpnToIndex.find(vpn);
-    if (it == nfuState.vpnToIndex.end()) return; // defensive: unknown page
+    if (it == nfuState.vpnToIndex.end()) return nfuState.pages.size(); // defensive: unknown page
 
     const size_t index = it->second;
     nfuState.pages[index].lastAccessTime = nfuState.currentTime;
@@ -87,6 +89,46 @@ void onHitNFU(uint32_t vpn) {
     if (nfuState.currentTime % nfuState.interval != 0) {
         nfuState.accessed.insert(vpn);
     }
+    return index;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Repeat hits on the page touched by the previous access.
+
+  - Equivalent to 'count' rounds of beforeAccessNFU() + onHitNFU(), but jumps
+    from one tick boundary to the next instead of stepping per access.
+  - Within an interval the page is added to 'accessed' at most once:
+    markedTick remembers which interval it was last added in.
+  - An access landing exactly on a boundary ticks and does not mark the page,
+    as in onHitNFU().
+
+  @param index       Index of the page in nfuState.pages.
+  @param count       Number of accesses to the page.
+  @param markedTick  nfuState.ticks when the page was last added to 'accessed'.
+───────────────────────────────────────────────────────────────────────────────*/
+void onRepeatHitsNFU(NFUState& nfuState, size_t index, uint64_t count, uint64_t& markedTick) {
+    const uint64_t vpn = nfuState.pages[index].vpn;
+
+    while (count > 0) {
+        const uint64_t untilTick = nfuState.interval - nfuState.timeSinceTick;
+        const uint64_t step      = min(count, untilTick);
+
+        // accesses before the boundary mark the page for this interval
+        const uint64_t marking = (step == untilTick) ? step - 1 : step;
+        if (marking > 0 && markedTick != nfuState.ticks) {
+            nfuState.accessed.insert(vpn);
+            markedTick = nfuState.ticks;
+        }
+
+        nfuState.currentTime   += step;
+        nfuState.timeSinceTick += step;
+        if (nfuState.timeSinceTick >= nfuState.interval) {
+            tickNFU(nfuState);
+        }
+        count -= step;
+    }
+
+    nfuState.pages[index].lastAccessTime = nfuState.currentTime;
 }
 
 /*───────────────────────────────────────────────────────────────────────────────
@@ -95,22 +137,28 @@ void onHitNFU(uint32_t vpn) {
   - Creates a new LoadedPage with MSB set (recently used).
   - Adds it to the page table and reverse index.
   - Marks it as accessed in this interval (except exactly on tick boundary).
+  - A prefetched page was not referenced: it starts from initialBits
+    (0, so it is the first to go if nobody uses it) and is not marked.
 
-  @param vpn  Virtual page number being loaded.
-  @param pfn  Physical frame number assigned to this VPN.
+  @param vpn          Virtual page number being loaded.
+  @param pfn          Physical frame number assigned to this VPN.
+  @param initialBits  Starting bitstring.
+  @param referenced   Whether the load is a reference to the page.
 ───────────────────────────────────────────────────────────────────────────────*/
-void onMissNFU(uint32_t vpn, int pfn) {
+void onMissNFU(NFUState& nfuState, uint64_t vpn, int pfn, uint16_t initialBits, bool referenced) {
     LoadedPage newPage{
         pfn,
         vpn,
-        static_cast<uint16_t>(0x8000), // recent use flagged in MSB
-        nfuState.currentTime
+        initialBits, // recent use flagged in MSB unless prefetched
+        nfuState.currentTime,
+        false,
+        0
     };
 
     nfuState.pages.push_back(newPage);
     nfuState.vpnToIndex[vpn] = nfuState.pages.size() - 1;
 
-    if (nfuState.currentTime % nfuState.interval != 0) {
+    if (referenced && nfuState.currentTime % nfuState.interval != 0) {
         nfuState.accessed.insert(vpn);
     }
 }
@@ -120,7 +168,7 @@ void onMissNFU(uint32_t vpn, int pfn) {
 
   @return true if all frames are currently in use; false otherwise.
 ───────────────────────────────────────────────────────────────────────────────*/
-bool isFullNFU() {
+bool isFullNFU(const NFUState& nfuState) {
     return nfuState.pages.size() >= static_cast<size_t>(nfuState.maxFrames);
 }
 
@@ -130,30 +178,45 @@ bool isFullNFU() {
   - Chooses the page with the smallest bitstring (least recent aggregate usage).
   - Ties broken by earliest lastAccessTime (older → evict first).
   - Final tie-breaker: smaller PFN (deterministic choice).
+  - Clean-first (cleanTolerance >= 0): if that victim is dirty, the best
+    clean page (same order) whose bitstring is at most cleanTolerance above
+    the victim's is taken instead, since evicting it needs no write-back.
+    Tolerance 0 only breaks bitstring ties in favour of clean pages.
+  - proc >= 0: only pages loaded by that process are candidates.
 
-  @return index into nfuState.pages of the victim, or -1 if no pages loaded.
+  @return index into nfuState.pages of the victim, or -1 if no candidate.
 ───────────────────────────────────────────────────────────────────────────────*/
-int selectVictimNFU() {
-    if (nfuState.pages.empty()) return -1;
+// true if page a should be evicted before page b under plain NFU
+static bool evictsBefore(const LoadedPage& a, const LoadedPage& b) {
+    if (a.bitstring != b.bitstring) return a.bitstring < b.bitstring;
+    if (a.lastAccessTime != b.lastAccessTime) return a.lastAccessTime < b.lastAccessTime;
+    return a.pfn < b.pfn;
+}
 
-    int victimIndex = 0;
+int selectVictimNFU(const NFUState& nfuState, int proc) {
+    int victimIndex = -1;
+    int cleanIndex  = -1; // best clean page, when clean-first is on
 
-    for (size_t i = 1; i < nfuState.pages.size(); i++) {
+    for (size_t i = 0; i < nfuState.pages.size(); i++) {
         const LoadedPage& cand = nfuState.pages[i];
-        const LoadedPage& best = nfuState.pages[static_cast<size_t>(victimIndex)];
-
-        const bool betterBitstring   = (cand.bitstring < best.bitstring);
-        const bool equalBitstring    = (cand.bitstring == best.bitstring);
-        const bool olderLastAccess   = (cand.lastAccessTime < best.lastAccessTime);
-        const bool equalLastAccess   = (cand.lastAccessTime == best.lastAccessTime);
-        const bool smallerPFN        = (cand.pfn < best.pfn);
+        if (proc >= 0 && cand.proc != proc) continue;
 
-        if (betterBitstring ||
-            (equalBitstring && (olderLastAccess || (equalLastAccess && smallerPFN)))) {
+        if (victimIndex < 0 || evictsBefore(cand, nfuState.pages[static_cast<size_t>(victimIndex)])) {
             victimIndex = static_cast<int>(i);
         }
+        if (nfuState.cleanTolerance >= 0 && !cand.dirty &&
+            (cleanIndex < 0 || evictsBefore(cand, nfuState.pages[static_cast<size_t>(cleanIndex)]))) {
+            cleanIndex = static_cast<int>(i);
+        }
     }
 
+    if (victimIndex >= 0 && cleanIndex >= 0 && nfuState.pages[static_cast<size_t>(victimIndex)].dirty) {
+        const uint32_t victimBits = nfuState.pages[static_cast<size_t>(victimIndex)].bitstring;
+        const uint32_t cleanBits  = nfuState.pages[static_cast<size_t>(cleanIndex)].bitstring;
+        if (cleanBits - victimBits <= static_cast<uint32_t>(nfuState.cleanTolerance)) {
+            return cleanIndex;
+        }
+    }
     return victimIndex;
 }
 
@@ -161,19 +224,24 @@ int selectVictimNFU() {
   Reuse a victim slot for a new VPN.
 
   - Removes the victim's VPN from the index & 'accessed' set.
-  - Overwrites the LoadedPage with the new VPN, resets bitstring (MSB=1),
-    and updates lastAccessTime.
-  - Adds new VPN to the index and marks it as accessed (except on tick boundary).
+  - Overwrites the LoadedPage with the new VPN, resets bitstring (MSB=1,
+    or initialBits for a prefetched page), updates lastAccessTime, and
+    clears dirty (the caller has written the victim back if needed).
+  - Adds new VPN to the index and marks it as accessed (except on tick
+    boundary, or when prefetched).
 
   @param victimIndex  Index of victim page in nfuState.pages.
   @param newVPN       VPN to place into victim's frame.
+  @param initialBits  Starting bitstring of the new page.
+  @param referenced   Whether the load is a reference to the new page.
 
   @return {oldVPN, oldBitstring} for logging/reporting.
 ───────────────────────────────────────────────────────────────────────────────*/
-pair<uint32_t, uint16_t> reuseSlotNFU(int victimIndex, uint32_t newVPN) {
+pair<uint64_t, uint16_t> reuseSlotNFU(NFUState& nfuState, int victimIndex, uint64_t newVPN,
+                                      uint16_t initialBits, bool referenced) {
     LoadedPage& victimPage = nfuState.pages[static_cast<size_t>(victimIndex)];
 
-    const uint32_t oldVPN       = victimPage.vpn;
+    const uint64_t oldVPN       = victimPage.vpn;
     const uint16_t oldBitstring = victimPage.bitstring;
 
     // Remove old mappings
@@ -182,13 +250,14 @@ pair<uint32_t, uint16_t> reuseSlotNFU(int victimIndex, uint32_t newVPN) {
 
     // Overwrite with new VPN, reset usage history and timestamp
     victimPage.vpn            = newVPN;
-    victimPage.bitstring      = static_cast<uint16_t>(0x8000); // mark as recently used
+    victimPage.bitstring      = initialBits; // recently used, unless prefetched
     victimPage.lastAccessTime = nfuState.currentTime;
+    victimPage.dirty          = false;
 
     // Add new mapping
     nfuState.vpnToIndex[newVPN] = victimIndex;
 
-    if (nfuState.currentTime % nfuState.interval != 0) {
+    if (referenced && nfuState.currentTime % nfuState.interval != 0) {
         nfuState.accessed.insert(newVPN);
     }
 
@@ -6,46 +6,32 @@
 
 #include "pageTable.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PAGETABLE_HAVE_AVX2_KERNEL 1
+#endif
+
 // Destructor
 PageTable::~PageTable() {
     if (rootLevel) {
         delete rootLevel;
         rootLevel = nullptr;
     }
-}
-
-static uint64_t countLevelEntries(const Level* node) {
-    if (!node) return 0;
-
-    uint64_t total = 0;
-
-    if (node->isLeaf) {
-        // Count ALL mapping slots at the leaf (if the array was allocated)
-        if (node->mappings) {
-            total += node->entryCount;
-        }
-        return total;
+    if (inverted) {
+        delete inverted;
+        inverted = nullptr;
     }
-
-    // Internal level: count ALL child slots (if the array was allocated)
-    if (node->children) {
-        total += node->entryCount;
-        for (unsigned i = 0; i < node->entryCount; ++i) {
-            if (node->children[i]) {
-                total += countLevelEntries(node->children[i]);
-            }
-        }
-    }
-    return total;
 }
 
 uint64_t PageTable::countEntries(const PageTable* pt) {
     if (!pt) return 0;
-    return countLevelEntries(pt->rootLevel);
+    // kept current by Level / InvertedPageTable as arrays come and go
+    return pt->stats.entries;
 }
 
-void PageTable::initFromLevelBits(const vector<int>& levelBits) {
+void PageTable::initFromLevelBits(const vector<int>& levelBits, unsigned addressBits_) {
     numLevels = levelBits.size();
+    addressBits = addressBits_;
 
     // sets the vector size to be the same as numLevels
     entryCount.resize(numLevels);
@@ -57,8 +43,8 @@ void PageTable::initFromLevelBits(const vector<int>& levelBits) {
     for(int bits : levelBits) { total += bits;}
 
     // sets amount of offset bits and offset's bitmask
-    offsetBits = 32u - (unsigned)total;
-    offsetMask = (1u << offsetBits) - 1u; // e.g. if offsetBits is 12, then 1u << 12 is 1 0000 0000 0000, -1u makes it 1111 1111 1111
+    offsetBits = addressBits - (unsigned)total;
+    offsetMask = (1ull << offsetBits) - 1ull; // e.g. if offsetBits is 12, then 1 << 12 is 1 0000 0000 0000, -1 makes it 1111 1111 1111
 
     // calculates the shifts for each level
     for (int i = numLevels - 1; i >=0; i--) {
@@ -72,29 +58,119 @@ void PageTable::initFromLevelBits(const vector<int>& levelBits) {
     // builds the entryCounts and bitmasks vectors
     for (int i = 0; i < numLevels; i++) {
         entryCount[i] = 1u << levelBits[i];
-        bitmasks[i] = ((1u << levelBits[i]) - 1u) << shifts[i];
+        bitmasks[i] = ((1ull << levelBits[i]) - 1ull) << shifts[i];
     }
 
     // root level allocated here
-    rootLevel = new Level(entryCount[0], numLevels == 1);
+    rootLevel = new Level(entryCount[0], numLevels == 1, 0, &stats);
 }
 
-// searches and returns the Map for the given virtual address
-Map* PageTable::searchMappedPfn(unsigned int virtualAddress) {
+void PageTable::useInvertedBackend(int maxFrames) {
+    if (!inverted) {
+        inverted = new InvertedPageTable();
+        inverted->stats = &stats;
+    }
+    inverted->init(maxFrames, offsetBits);
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Batch address decomposition.
+
+  Both kernels do, for every address and level:
+      pieces[level][i] = (vaddr & bitmasks[level]) >> shifts[level]
+      offsets[i]       =  vaddr & offsetMask
+  The AVX2 kernel handles four addresses per step (64-bit lanes, narrowed
+  to 32-bit indices), the scalar loop finishes the tail.
+───────────────────────────────────────────────────────────────────────────────*/
+static void decomposeScalar(const PageTable& pt, const uint64_t* vaddrs, size_t begin, size_t n,
+                            uint32_t* const* pieces, uint64_t* offsets) {
+    for (int level = 0; level < pt.numLevels; level++) {
+        const uint64_t mask = pt.bitmasks[level];
+        const unsigned shift = pt.shifts[level];
+        uint32_t* row = pieces[level];
+        for (size_t i = begin; i < n; i++) {
+            row[i] = (uint32_t)((vaddrs[i] & mask) >> shift);
+        }
+    }
+    for (size_t i = begin; i < n; i++) {
+        offsets[i] = vaddrs[i] & pt.offsetMask;
+    }
+}
+
+#ifdef PAGETABLE_HAVE_AVX2_KERNEL
+// returns the number of addresses handled (a multiple of 4)
+__attribute__((target("avx2")))
+static size_t decomposeAVX2(const PageTable& pt, const uint64_t* vaddrs, size_t n,
+                            uint32_t* const* pieces, uint64_t* offsets) {
+    const size_t blocks = n & ~(size_t)3;
+    // picks the low dword of each 64-bit lane into the low 128 bits
+    const __m256i narrow = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+    const __m256i offsetMask = _mm256_set1_epi64x((long long)pt.offsetMask);
+
+    for (int level = 0; level < pt.numLevels; level++) {
+        const __m256i mask = _mm256_set1_epi64x((long long)pt.bitmasks[level]);
+        const __m128i shift = _mm_cvtsi32_si128((int)pt.shifts[level]);
+        uint32_t* row = pieces[level];
+        for (size_t i = 0; i < blocks; i += 4) {
+            const __m256i v = _mm256_loadu_si256((const __m256i*)(vaddrs + i));
+            const __m256i piece = _mm256_srl_epi64(_mm256_and_si256(v, mask), shift);
+            const __m256i packed = _mm256_permutevar8x32_epi32(piece, narrow);
+            _mm_storeu_si128((__m128i*)(row + i), _mm256_castsi256_si128(packed));
+        }
+    }
+    for (size_t i = 0; i < blocks; i += 4) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(vaddrs + i));
+        _mm256_storeu_si256((__m256i*)(offsets + i), _mm256_and_si256(v, offsetMask));
+    }
+    return blocks;
+}
+#endif
+
+void PageTable::decomposeBatch(const uint64_t* vaddrs, size_t n, uint32_t* const* pieces, uint64_t* offsets) const {
+    size_t done = 0;
+#ifdef PAGETABLE_HAVE_AVX2_KERNEL
+    static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+    if (hasAVX2) {
+        done = decomposeAVX2(*this, vaddrs, n, pieces, offsets);
+    }
+#endif
+    decomposeScalar(*this, vaddrs, done, n, pieces, offsets);
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Tree walks, shared by the address and the precomputed-index entry points.
+  pieceAt(depth) returns the VPN piece used at that depth.
+
+  With the page walk cache on, a walk starts from the deepest cached level
+  on the address's path and caches every level it passes below that. Only
+  demand searches (countWalk) count in the cache's walk statistics.
+───────────────────────────────────────────────────────────────────────────────*/
+static Level* walkStart(PageTable& pt, uint64_t virtualAddress, bool countWalk) {
+    if (pt.walkCache.enabled()) {
+        unsigned depth;
+        Level* cached = countWalk ? pt.walkCache.lookup(virtualAddress) : pt.walkCache.probe(virtualAddress, depth);
+        if (cached) return cached;
+    }
+    return pt.rootLevel;
+}
+
+template <typename PieceAt>
+static Map* searchWalk(PageTable& pt, uint64_t virtualAddress, PieceAt pieceAt, bool countWalk) {
     // preliminary checks
-    if (!rootLevel || numLevels <= 0) { return nullptr;}
+    if (!pt.rootLevel || pt.numLevels <= 0) { return nullptr;}
 
     // traverse the page table levels to get to desired leaf level
-    Level* currentLevel = rootLevel;
+    Level* currentLevel = walkStart(pt, virtualAddress, countWalk);
     while (!currentLevel->isLeaf) {
-        currentLevel = currentLevel->getChild(getVPNPiece(virtualAddress, currentLevel->depth));
+        currentLevel = currentLevel->getChild(pieceAt(currentLevel->depth));
         if (!currentLevel) {
             return nullptr;
         }
+        pt.walkCache.fill(virtualAddress, currentLevel->depth, currentLevel);
     }
 
     // at lead level, get the mapping, check validity, and return
-    unsigned vpnPiece = getVPNPiece(virtualAddress, currentLevel->depth);
+    unsigned vpnPiece = pieceAt(currentLevel->depth);
     if (!currentLevel->mappings) {
         return nullptr;
     }
@@ -106,31 +182,108 @@ Map* PageTable::searchMappedPfn(unsigned int virtualAddress) {
     }
 }
 
-// inserts a mapping from the given virtual address to the given frame number
-void  PageTable::insertMapForVpn2Pfn(unsigned int virtualAddress, int frame) {
-        // preliminary checks
-    if (!rootLevel || numLevels <= 0) { return;}
+template <typename PieceAt>
+static Map* insertWalk(PageTable& pt, uint64_t virtualAddress, PieceAt pieceAt, int frame) {
+    // preliminary checks
+    if (!pt.rootLevel || pt.numLevels <= 0) { return nullptr;}
 
     // traverse the page table levels to get to desired leaf level
-    Level* currentLevel = rootLevel;
+    Level* currentLevel = walkStart(pt, virtualAddress, false);
     while (!currentLevel->isLeaf) {
-        unsigned vpnPiece = getVPNPiece(virtualAddress, currentLevel->depth);
-        unsigned childEntryCount = entryCount[currentLevel->depth + 1];
-        bool childIsLeaf = (currentLevel->depth + 1 == (unsigned)(numLevels - 1));
+        unsigned vpnPiece = pieceAt(currentLevel->depth);
+        unsigned childEntryCount = pt.entryCount[currentLevel->depth + 1];
+        bool childIsLeaf = (currentLevel->depth + 1 == (unsigned)(pt.numLevels - 1));
         currentLevel = currentLevel->ensureChild(vpnPiece, childEntryCount, childIsLeaf);
+        pt.walkCache.fill(virtualAddress, currentLevel->depth, currentLevel);
     }
 
     // at leaf level, set the mapping and mark valid
-    unsigned vpnPiece = getVPNPiece(virtualAddress, currentLevel->depth);
+    unsigned vpnPiece = pieceAt(currentLevel->depth);
     if (!currentLevel->mappings) {
         currentLevel->allocateMappings();
     }
     Map* mapping = currentLevel->getMapping(vpnPiece);
+    if (!mapping->valid) {
+        currentLevel->liveCount++;
+    }
     mapping->pfn = frame;
     mapping->valid = true;
+    mapping->dirty = false;
+    return mapping;
+}
+
+// searches and returns the Map for the given virtual address
+Map* PageTable::searchMappedPfn(uint64_t virtualAddress) {
+    if (inverted) { return inverted->searchMappedPfn(virtualAddress); }
+
+    return searchWalk(*this, virtualAddress, [&](unsigned depth) { return getVPNPiece(virtualAddress, depth); }, true);
+}
+
+// same as above, walking with indices precomputed by decomposeBatch
+Map* PageTable::searchMappedPfn(uint64_t virtualAddress, const AddressBatch& batch, size_t i) {
+    if (inverted) { return inverted->searchMappedPfn(virtualAddress); }
+
+    return searchWalk(*this, virtualAddress, [&](unsigned depth) { return batch.rows[depth][i]; }, true);
+}
+
+// searchMappedPfn for the simulator's own lookups, not counted as walk cache walks
+Map* PageTable::probeMappedPfn(uint64_t virtualAddress) {
+    if (inverted) { return inverted->searchMappedPfn(virtualAddress); }
+
+    return searchWalk(*this, virtualAddress, [&](unsigned depth) { return getVPNPiece(virtualAddress, depth); }, false);
+}
+
+// inserts a mapping from the given virtual address to the given frame number, returns it
+Map* PageTable::insertMapForVpn2Pfn(uint64_t virtualAddress, int frame) {
+    if (inverted) { return inverted->insertMapForVpn2Pfn(virtualAddress, frame); }
+
+    return insertWalk(*this, virtualAddress, [&](unsigned depth) { return getVPNPiece(virtualAddress, depth); }, frame);
+}
+
+// same as above, walking with indices precomputed by decomposeBatch
+Map* PageTable::insertMapForVpn2Pfn(uint64_t virtualAddress, const AddressBatch& batch, size_t i, int frame) {
+    if (inverted) { return inverted->insertMapForVpn2Pfn(virtualAddress, frame); }
+
+    return insertWalk(*this, virtualAddress, [&](unsigned depth) { return batch.rows[depth][i]; }, frame);
+}
+
+// invalidates the mapping below node, returns true if node has no live entries left
+static bool removeFromLevel(PageTable& pt, Level* node, uint64_t virtualAddress) {
+    unsigned vpnPiece = pt.getVPNPiece(virtualAddress, node->depth);
+
+    if (node->isLeaf) {
+        Map* mapping = node->getMapping(vpnPiece);
+        if (mapping && mapping->valid) {
+            mapping->valid = false;
+            node->liveCount--;
+        }
+        return node->liveCount == 0;
+    }
+
+    Level* child = node->getChild(vpnPiece);
+    if (child && removeFromLevel(pt, child, virtualAddress) && pt.reclaimEmptyLevels) {
+        // the whole subtree under this slot is empty (so child has no children
+        // of its own to uncache), give its memory back
+        pt.walkCache.invalidate(virtualAddress, child->depth);
+        node->releaseChild(vpnPiece);
+    }
+    return node->liveCount == 0;
+}
+
+// invalidates the mapping for the given virtual address
+void  PageTable::removeMapForVpn2Pfn(uint64_t virtualAddress) {
+    if (inverted) { inverted->removeMapForVpn2Pfn(virtualAddress); return; }
+
+    // preliminary checks
+    if (!rootLevel || numLevels <= 0) { return;}
+
+    // the root level itself is kept, only its arrays are released
+    if (removeFromLevel(*this, rootLevel, virtualAddress) && reclaimEmptyLevels) {
+        rootLevel->releaseStorage();
+    }
 }
 
 // extracts the VPN piece from the given virtual address using the given mask and shift
-unsigned int extractVPNFromVirtualAddress(unsigned int virtualAddress, unsigned int mask, unsigned int shift) {
-    return (virtualAddress & mask) >> shift;
+unsigned int extractVPNFromVirtualAddress(uint64_t virtualAddress, uint64_t mask, unsigned int shift) {
+    return (unsigned int)((virtualAddress & mask) >> shift);
 }
\ No newline at end of file
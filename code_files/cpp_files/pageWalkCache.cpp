@@ -0,0 +1,59 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "pageWalkCache.h"
+#include <cstdlib>
+
+bool parseWalkCacheSpec(const string& spec, vector<unsigned>& entriesPerDepth) {
+    entriesPerDepth.clear();
+    size_t pos = 0;
+    while (true) {
+        const size_t comma = spec.find(',', pos);
+        const string field = spec.substr(pos, comma == string::npos ? string::npos : comma - pos);
+        if (field.empty() || field.size() > 7 || field.find_first_not_of("0123456789") != string::npos) {
+            return false;
+        }
+        entriesPerDepth.push_back((unsigned)atoi(field.c_str()));
+        if (comma == string::npos) break;
+        pos = comma + 1;
+    }
+    return true;
+}
+
+void PageWalkCache::init(const vector<unsigned>& entriesPerDepth, const vector<unsigned>& shifts,
+                         unsigned addressBits) {
+    const size_t depths = shifts.size(); // one per page table level
+    entries.assign(depths, {});
+    keyShift.assign(depths, 0);
+    keyMask.assign(depths, 0);
+    indexMask.assign(depths, 0);
+    resumedAt.assign(depths, 0);
+    walks = 0;
+    lastStartDepth = 0;
+    deepest = 0;
+
+    for (size_t depth = 1; depth < depths && depth <= entriesPerDepth.size(); depth++) {
+        const unsigned wanted = entriesPerDepth[depth - 1];
+        if (wanted == 0) continue;
+
+        size_t size = 1;
+        while (size < wanted) size <<= 1;
+        entries[depth].assign(size, Entry{});
+        keyShift[depth] = shifts[depth - 1];
+        keyMask[depth] = ((uint64_t)1 << (addressBits - keyShift[depth])) - 1;
+        indexMask[depth] = size - 1;
+        deepest = (int)depth;
+    }
+}
+
+void PageWalkCache::invalidate(uint64_t vaddr, unsigned depth) {
+    if ((int)depth > deepest || entries[depth].empty()) return;
+    const uint64_t key = keyOf(vaddr, depth);
+    Entry& entry = entries[depth][slotOf(depth, key)];
+    if (entry.level && entry.key == key) {
+        entry.level = nullptr;
+    }
+}
@@ -0,0 +1,222 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "pipeline.h"
+#include "checkpoint.h"
+#include "intervalStats.h"
+#include "log_helpers.h"
+#include "spscRing.h"
+#include <pthread.h>
+#include <sched.h>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Batches flow decode -> split -> simulate -> format and then back to decode
+  through the free ring, so no stage allocates once the pool is built.
+  A nullptr pushed down the rings marks the end of the trace.
+───────────────────────────────────────────────────────────────────────────────*/
+
+static const size_t BATCH_SIZE   = 1024; // accesses per batch
+static const size_t RING_SIZE    = 16;   // batches in flight between two stages
+static const size_t POOL_SIZE    = 16;   // batches allocated for the whole run
+static const size_t OUT_BUF_SIZE = 1 << 16; // formatting stage flushes stdout in chunks this big
+
+struct PipelineBatch {
+    AddressBatch addrs; // stage 1: addresses, stage 2: per-level indices and offsets
+    int pfn[BATCH_SIZE]; // stage 3: mapped frame, -1 if unmapped
+    bool pthit[BATCH_SIZE]; // stage 3: page table hit
+    int64_t vpnReplaced[BATCH_SIZE]; // stage 3: evicted VPN, -1 if none
+    uint16_t victimBitstring[BATCH_SIZE]; // stage 3: evicted page's NFU bitstring
+};
+
+typedef SpscRing<PipelineBatch*, RING_SIZE> BatchRing;
+typedef SpscRing<PipelineBatch*, POOL_SIZE> FreeRing;
+
+// Pins the calling thread to one core so the stages don't migrate onto each other
+static void pinToCore(unsigned stage) {
+    const unsigned cores = thread::hardware_concurrency();
+    if (cores < 2) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(stage % cores, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set); // best effort
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Stage 1: trace decode.
+───────────────────────────────────────────────────────────────────────────────*/
+static void decodeStage(TraceSource& source, int64_t limit, FreeRing& freeRing, BatchRing& out) {
+    pinToCore(0);
+    p2AddrTr64 mTrace{};
+    int64_t decoded = 0;
+    bool more = true;
+
+    while (more) {
+        PipelineBatch* batch = freeRing.pop();
+        AddressBatch& addrs = batch->addrs;
+        addrs.count = 0;
+        while (addrs.count < BATCH_SIZE) {
+            if ((limit >= 0 && decoded >= limit) || !source.next(&mTrace)) {
+                more = false;
+                break;
+            }
+            addrs.write[addrs.count] = isWriteRecord(mTrace);
+            addrs.proc[addrs.count]  = mTrace.proc;
+            addrs.vaddr[addrs.count++] = mTrace.addr;
+            decoded++;
+        }
+        // an empty last batch just stays out of circulation: the formatter is
+        // the free ring's only producer, and runPipelined frees the whole pool
+        if (addrs.count > 0) {
+            out.push(batch);
+        }
+    }
+    out.push(nullptr);
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Stage 2: VPN / offset extraction.
+───────────────────────────────────────────────────────────────────────────────*/
+static void splitStage(const PageTable& pt, BatchRing& in, BatchRing& out) {
+    pinToCore(1);
+
+    while (PipelineBatch* batch = in.pop()) {
+        pt.decomposeBatch(batch->addrs);
+        out.push(batch);
+    }
+    out.push(nullptr);
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Stage 3: page table + NFU. The only stage that touches the simulator.
+───────────────────────────────────────────────────────────────────────────────*/
+static void simulateStage(Simulator& simulator, const RunOptions& opts, IntervalRecorder& intervals,
+                          uint64_t startOffset, long recordSize, BatchRing& in, BatchRing& out) {
+    pinToCore(2);
+    const PageTable& pt = simulator.pt;
+    const SimCounters& sim = simulator.counters;
+    // fixed-size records: the trace offset of access N is known without asking stage 1
+    const int64_t startCount = sim.count;
+
+    while (PipelineBatch* batch = in.pop()) {
+        for (size_t i = 0; i < batch->addrs.count; i++) {
+            const AccessOutcome outcome = simulator.access(batch->addrs, i);
+
+            batch->pfn[i]             = (outcome.mapping && outcome.mapping->valid) ? outcome.mapping->pfn : -1;
+            batch->pthit[i]           = outcome.pthit;
+            batch->vpnReplaced[i]     = outcome.vpnReplaced;
+            batch->victimBitstring[i] = outcome.victimBitstring;
+
+            intervals.touch(batch->addrs.vaddr[i] >> pt.offsetBits);
+            intervals.afterAccess(pt, sim);
+
+            if (sim.count == opts.checkpointAt) {
+                saveCheckpoint(opts.checkpointFile, simulator, opts.filter,
+                               startOffset + (uint64_t)(sim.count - startCount) * recordSize);
+            }
+        }
+        out.push(batch);
+    }
+    out.push(nullptr);
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Stage 4: output formatting, buffered instead of flushed per line.
+───────────────────────────────────────────────────────────────────────────────*/
+static void formatStage(const PageTable& pt, PipelineOutput output, BatchRing& in, FreeRing& freeRing) {
+    pinToCore(3);
+    vector<char> buf(OUT_BUF_SIZE);
+    size_t used = 0;
+    const int levels = pt.numLevels;
+    vector<uint32_t> vpnPieces(levels); // one access's pieces, gathered from the batch rows
+
+    while (PipelineBatch* batch = in.pop()) {
+        const AddressBatch& addrs = batch->addrs;
+        for (size_t i = 0; i < addrs.count && output != PipelineOutput::None; i++) {
+            if (OUT_BUF_SIZE - used < LOG_LINE_MAX) {
+                fwrite(buf.data(), 1, used, stdout);
+                used = 0;
+            }
+            char* line = buf.data() + used;
+            switch (output) {
+                case PipelineOutput::Va2pa:
+                    used += format_va2pa(line, LOG_LINE_MAX, addrs.vaddr[i],
+                                         ((uint64_t)batch->pfn[i] << pt.offsetBits) | addrs.offset[i]);
+                    break;
+                case PipelineOutput::VpnsPfn:
+                    for (int level = 0; level < levels; level++) {
+                        vpnPieces[level] = addrs.rows[level][i];
+                    }
+                    used += format_vpns_pfn(line, LOG_LINE_MAX, levels, vpnPieces.data(),
+                                            (uint32_t)batch->pfn[i]);
+                    break;
+                case PipelineOutput::Vpn2pfnPr:
+                    used += format_mapping(line, LOG_LINE_MAX, addrs.vaddr[i] >> pt.offsetBits,
+                                           (uint64_t)(int64_t)batch->pfn[i],
+                                           batch->vpnReplaced[i], batch->victimBitstring[i], batch->pthit[i]);
+                    break;
+                case PipelineOutput::None:
+                    break;
+            }
+        }
+        freeRing.push(batch);
+    }
+
+    fwrite(buf.data(), 1, used, stdout);
+    fflush(stdout);
+}
+
+int runPipelined(const vector<string>& traceFiles, Simulator& simulator, const RunOptions& opts, PipelineOutput output) {
+    const PageTable& pt = simulator.pt;
+    const SimCounters& sim = simulator.counters;
+    TraceSource source;
+    if (!openTraceForRun(traceFiles, simulator, opts, source)) {
+        return 1;
+    }
+    const uint64_t startOffset = source.position();
+    const int64_t limit = opts.numAccesses > 0 ? max<int64_t>(opts.numAccesses - sim.count, 0) : -1;
+
+    // written by the simulate stage; main rejects stdout here since stage 4 owns it
+    IntervalRecorder intervals;
+    if (!intervals.open(opts, sim)) {
+        return 1;
+    }
+
+    // the rings are large (cache-line aligned slots), keep them off the stack
+    FreeRing* freeRing = new FreeRing();
+    BatchRing* decoded = new BatchRing();
+    BatchRing* split   = new BatchRing();
+    BatchRing* mapped  = new BatchRing();
+
+    vector<PipelineBatch*> pool;
+    for (size_t i = 0; i < POOL_SIZE; i++) {
+        PipelineBatch* batch = new PipelineBatch();
+        batch->addrs.init(pt.numLevels, BATCH_SIZE);
+        pool.push_back(batch);
+        freeRing->push(batch);
+    }
+
+    thread decoder(decodeStage, ref(source), limit, ref(*freeRing), ref(*decoded));
+    thread splitter(splitStage, cref(pt), ref(*decoded), ref(*split));
+    thread translator(simulateStage, ref(simulator), cref(opts), ref(intervals), startOffset, source.recordBytes(), ref(*split), ref(*mapped));
+    thread formatter(formatStage, cref(pt), output, ref(*mapped), ref(*freeRing));
+
+    decoder.join();
+    splitter.join();
+    translator.join();
+    formatter.join();
+    intervals.close(pt, sim);
+
+    for (PipelineBatch* batch : pool) delete batch;
+    delete freeRing;
+    delete decoded;
+    delete split;
+    delete mapped;
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "prefetch.h"
+#include <algorithm>
+#include <cstdlib>
+
+static const uint64_t INITIAL_WINDOW = 4; // Adaptive: pages in the first window
+
+bool parsePrefetchSpec(const string& spec, PrefetchConfig& config) {
+    const size_t colon = spec.find(':');
+    if (colon == string::npos) return false;
+    const string name = spec.substr(0, colon);
+    const string count = spec.substr(colon + 1);
+    if (count.empty() || count.size() > 4 || count.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+
+    if (name == "next") {
+        config.policy = PrefetchPolicy::NextN;
+    } else if (name == "stride") {
+        config.policy = PrefetchPolicy::Stride;
+    } else if (name == "adaptive") {
+        config.policy = PrefetchPolicy::Adaptive;
+    } else {
+        return false;
+    }
+    config.degree = (unsigned)atoi(count.c_str());
+    return config.degree >= 1 && config.degree <= 1024;
+}
+
+void Prefetcher::init(const PrefetchConfig& config_, uint64_t maxVpn_) {
+    config = config_;
+    stats = PrefetchStats{};
+    unused.clear();
+    maxVpn = maxVpn_;
+    haveFault = false;
+    lastStride = 0;
+    windowSize = 0;
+    marker = UINT64_MAX;
+}
+
+// first, first + step, ... (count pages), stopping at either end of the address space
+void Prefetcher::addRun(uint64_t first, int64_t step, uint64_t count, vector<uint64_t>& out) const {
+    uint64_t vpn = first;
+    for (uint64_t i = 0; i < count; i++) {
+        if (vpn > maxVpn) return;
+        out.push_back(vpn);
+        if (step < 0 && vpn < (uint64_t)-step) return;
+        vpn += (uint64_t)step;
+    }
+}
+
+void Prefetcher::openWindow(uint64_t start, uint64_t size, vector<uint64_t>& out) {
+    windowStart = start;
+    windowSize = size;
+    marker = start;
+    addRun(start, 1, size, out);
+}
+
+void Prefetcher::readAhead(vector<uint64_t>& out) {
+    openWindow(windowStart + windowSize, min<uint64_t>(windowSize * 2, config.degree), out);
+}
+
+void Prefetcher::onFault(uint64_t vpn, vector<uint64_t>& out) {
+    const int64_t stride = (int64_t)(vpn - lastFault);
+    const bool sequential = haveFault && (vpn == lastFault + 1 || (windowSize > 0 && vpn == windowStart + windowSize));
+
+    switch (config.policy) {
+        case PrefetchPolicy::NextN:
+            if (vpn < maxVpn) addRun(vpn + 1, 1, config.degree, out);
+            break;
+        case PrefetchPolicy::Stride:
+            if (haveFault && stride != 0 && stride == lastStride) {
+                const bool inRange = stride > 0 ? vpn <= maxVpn - (uint64_t)stride : vpn >= (uint64_t)-stride;
+                if (inRange) addRun(vpn + (uint64_t)stride, stride, config.degree, out);
+            }
+            break;
+        case PrefetchPolicy::Adaptive:
+            // other faults leave the open window alone, so unrelated faults
+            // interleaved with a sequential scan don't stop its readahead
+            if (sequential && vpn < maxVpn) {
+                const uint64_t size = windowSize == 0 ? INITIAL_WINDOW : windowSize * 2;
+                openWindow(vpn + 1, min<uint64_t>(size, config.degree), out);
+            }
+            break;
+        case PrefetchPolicy::None:
+            break;
+    }
+
+    lastStride = haveFault ? stride : 0;
+    lastFault = vpn;
+    haveFault = true;
+}
@@ -0,0 +1,54 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "sampling.h"
+#include <cmath>
+#include <cstdlib>
+
+// parses one non-negative count, advancing pos past it and an optional comma
+static bool parseCount(const string& spec, size_t& pos, int64_t& value) {
+    const size_t comma = spec.find(',', pos);
+    const string field = spec.substr(pos, comma == string::npos ? string::npos : comma - pos);
+    if (field.empty() || field.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    value = atoll(field.c_str());
+    pos = (comma == string::npos) ? spec.size() : comma + 1;
+    return true;
+}
+
+bool parseSampleWindows(const string& spec, SampleWindows& windows) {
+    size_t pos = 0;
+    if (!parseCount(spec, pos, windows.fastForward) ||
+        !parseCount(spec, pos, windows.warmup) ||
+        !parseCount(spec, pos, windows.measure)) {
+        return false;
+    }
+    return pos == spec.size() && windows.measure > 0;
+}
+
+double SampleStats::stddev() const {
+    return n > 1 ? sqrt(m2 / (double)(n - 1)) : 0.0;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  95% confidence half width = t(n-1) * s / sqrt(n).
+
+  Student's t critical values (two-sided, 95%) for small window counts;
+  past 30 degrees of freedom the normal value 1.96 is close enough.
+───────────────────────────────────────────────────────────────────────────────*/
+double SampleStats::halfWidth95() const {
+    static const double T95[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (n < 2) return 0.0;
+
+    const uint64_t df = n - 1;
+    const double t = df <= 30 ? T95[df - 1] : 1.96;
+    return t * stddev() / sqrt((double)n);
+}
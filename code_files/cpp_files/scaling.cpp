@@ -0,0 +1,129 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "scaling.h"
+#include "concurrentPageTable.h"
+#include "traceSource.h"
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <thread>
+
+// Timed runs per thread count, the fastest is reported
+static const int SCALING_RUNS = 3;
+
+// One access of the in-memory trace
+struct ScalingAccess {
+    uint64_t vaddr;
+    bool write;
+};
+
+// What one thread did during one run
+struct ScalingWorker {
+    uint64_t installs = 0; // pages it mapped
+    uint64_t races = 0; // pages another thread mapped first
+    uint64_t checksum = 0; // sum of the frames it got, keeps the loop from being optimized away
+};
+
+static void translateSlice(ConcurrentPageTable& table, const ScalingAccess* first, const ScalingAccess* last,
+                           atomic<uint32_t>& nextFrame, atomic<int>& ready, const atomic<bool>& go,
+                           ScalingWorker& worker) {
+    ready.fetch_add(1, memory_order_release);
+    while (!go.load(memory_order_acquire)) this_thread::yield();
+
+    uint64_t installs = 0, races = 0, checksum = 0;
+    for (const ScalingAccess* a = first; a != last; a++) {
+        uint32_t pfn = 0;
+        const ConcurrentOutcome outcome = table.translate(a->vaddr, a->write, nextFrame, pfn);
+        installs += outcome == ConcurrentOutcome::Installed;
+        races += outcome == ConcurrentOutcome::LostRace;
+        checksum += pfn;
+    }
+    worker.installs = installs;
+    worker.races = races;
+    worker.checksum = checksum;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  One timed run: threads start together once they all exist, so thread
+  creation is not part of the time.
+───────────────────────────────────────────────────────────────────────────────*/
+struct ScalingRun {
+    double seconds = 0;
+    uint64_t installs = 0;
+    uint64_t races = 0;
+    uint64_t mapped = 0;
+};
+
+static ScalingRun timeRun(const PageTable& layout, const vector<ScalingAccess>& accesses, int threads) {
+    ConcurrentPageTable table;
+    table.init(layout);
+    atomic<uint32_t> nextFrame{0};
+    atomic<int> ready{0};
+    atomic<bool> go{false};
+    vector<ScalingWorker> workers((size_t)threads);
+    vector<thread> pool;
+
+    const size_t n = accesses.size();
+    for (int t = 0; t < threads; t++) {
+        const ScalingAccess* first = accesses.data() + n * (size_t)t / (size_t)threads;
+        const ScalingAccess* last = accesses.data() + n * (size_t)(t + 1) / (size_t)threads;
+        pool.emplace_back(translateSlice, ref(table), first, last, ref(nextFrame), ref(ready), cref(go),
+                          ref(workers[(size_t)t]));
+    }
+    while (ready.load(memory_order_acquire) < threads) this_thread::yield();
+
+    const auto start = chrono::steady_clock::now();
+    go.store(true, memory_order_release);
+    for (thread& worker : pool) worker.join();
+    const auto stop = chrono::steady_clock::now();
+
+    ScalingRun run;
+    run.seconds = chrono::duration<double>(stop - start).count();
+    for (const ScalingWorker& worker : workers) {
+        run.installs += worker.installs;
+        run.races += worker.races;
+    }
+    run.mapped = table.countMapped();
+    return run;
+}
+
+int runScaling(const vector<string>& traceFiles, const PageTable& layout, int64_t numAccesses,
+               const TraceFilter& filter, int maxThreads) {
+    TraceSource source;
+    if (!source.open(traceFiles, layout, filter)) {
+        return 1;
+    }
+
+    vector<ScalingAccess> accesses;
+    p2AddrTr64 rec{};
+    while ((numAccesses <= 0 || (int64_t)accesses.size() < numAccesses) && source.next(&rec)) {
+        accesses.push_back({rec.addr, isWriteRecord(rec)});
+    }
+    source.close();
+
+    vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    printf("threads,seconds,accesses,maccesses_per_sec,speedup,installs,races,mapped_pages\n");
+    double oneThread = 0;
+    for (int threads : threadCounts) {
+        ScalingRun best;
+        for (int r = 0; r < SCALING_RUNS; r++) {
+            const ScalingRun run = timeRun(layout, accesses, threads);
+            if (r == 0 || run.seconds < best.seconds) best = run;
+        }
+        if (threads == 1) oneThread = best.seconds;
+
+        const double rate = best.seconds > 0 ? (double)accesses.size() / best.seconds / 1e6 : 0;
+        const double speedup = best.seconds > 0 ? oneThread / best.seconds : 0;
+        printf("%d,%.6f,%zu,%.2f,%.2f,%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n", threads, best.seconds,
+               accesses.size(), rate, speedup, best.installs, best.races, best.mapped);
+    }
+
+    return 0;
+}
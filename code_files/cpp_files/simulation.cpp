@@ -0,0 +1,483 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "simulation.h"
+#include "checkpoint.h"
+#include "nfu.h"
+#include <algorithm>
+#include <iostream>
+
+void Simulator::init(const SimulatorConfig& config) {
+    pt.initFromLevelBits(config.levelBits, config.addressBits);
+    pt.reclaimEmptyLevels = config.reclaimLevels;
+    pt.useSparseLevels((uint8_t)config.sparseFill);
+    if (config.inverted) {
+        pt.useInvertedBackend(config.frames);
+    } else if (!config.walkCache.empty()) {
+        pt.useWalkCache(config.walkCache);
+    }
+    initNFUState(nfu, config.frames, config.bitUpdateInterval);
+    nfu.cleanTolerance = config.cleanTolerance;
+    allocator.init(config.alloc, config.frames);
+    prefetcher.init(config.prefetch, (pt.addressBits - pt.offsetBits >= 64) ? UINT64_MAX
+                                     : ((uint64_t)1 << (pt.addressBits - pt.offsetBits)) - 1);
+    caches.init(config.caches);
+    if (config.latencyModel) {
+        // the inverted table answers a walk with one hash probe
+        latency.init(config.latency, config.inverted ? 1 : (unsigned)pt.numLevels);
+    }
+    counters = SimCounters{};
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  One memory access.
+
+  - Advances NFU time, then looks the address up in the page table.
+  - Hit: refresh the page's NFU state.
+  - Miss with a free frame: map the page into the next unused frame.
+  - Miss with all frames used: evict the NFU victim, unmap it, and reuse
+    its frame for the new page. A dirty victim is written back first.
+  - A write sets the dirty bit of the page, in its PTE and NFU entry.
+  - With per-process frame allocation the allocator decides between a free
+    frame and a victim (see pickVictim).
+  - Same page as the previous access: a guaranteed hit, served from
+    counters.run without walking the table or looking the page up in NFU.
+  - With a prefetch policy, a miss (or the first hit on a readahead marker)
+    then loads the pages the policy picks; see installPrefetches.
+
+  search() / insert(frame) walk the table for the accessed address, either
+  from the address itself or from precomputed batch indices; insert returns
+  the Map it wrote. Only search() is a demand walk for the walk cache's
+  statistics, the simulator's other lookups use probeMappedPfn. With a cache
+  model, the translated physical address then goes through the caches.
+───────────────────────────────────────────────────────────────────────────────*/
+template <typename Search, typename Insert>
+AccessOutcome Simulator::accessStep(uint64_t vaddr, bool write, uint8_t proc, Search search, Insert insert) {
+    AccessOutcome out;
+    SimCounters& sim = counters;
+    const uint64_t vpn = vaddr >> pt.offsetBits;
+
+    if (sim.run.at == sim.count && sim.run.vpn == vpn) {
+        repeatStep(1, write, proc);
+        out.mapping = sim.run.mapping;
+        out.pthit   = true;
+        if (caches.enabled()) {
+            caches.access(((uint64_t)out.mapping->pfn << pt.offsetBits) | pt.getOffset(vaddr));
+        }
+        recorder.record(FlightEventType::Hit, vaddr, (uint32_t)out.mapping->pfn, proc, write ? FLIGHT_WRITE : 0);
+        recorder.afterAccesses(1, 0, (uint64_t)sim.count);
+        return out;
+    }
+
+    const uint64_t ticksBefore = nfu.ticks;
+    beforeAccessNFU(nfu);
+    recordTicks(ticksBefore);
+    if (allocator.enabled()) {
+        allocator.onAccess(proc, 1, nfu.currentTime);
+    }
+
+    Map* mapping = search();
+    const unsigned skipped = pt.walkCache.lastStartDepth; // levels the walk cache saved
+    out.walkSkipped = (uint8_t)skipped;
+    size_t nfuIndex;
+
+    if (mapping && mapping->valid) {
+        // Page table hit
+        out.pthit = true;
+        sim.hits++;
+        nfuIndex = onHitNFU(nfu, vpn);
+        latency.walkHit(skipped);
+        if (prefetcher.enabled()) {
+            prefetcher.onHit(vpn, prefetchQueue);
+        }
+    } else {
+        // Page table miss
+        if (allocator.enabled()) {
+            allocator.onFault(proc, nfu.currentTime);
+        }
+        const int victimIndex = pickVictim(proc);
+
+        if (victimIndex < 0) {
+            // Free frame available: install mapping
+            sim.framesAllocated++;
+            latency.minorFault(skipped);
+            mapping = insert(sim.nextFreePFN);
+            onMissNFU(nfu, vpn, sim.nextFreePFN);
+            nfuIndex = nfu.pages.size() - 1;
+            sim.nextFreePFN++;
+            if (allocator.enabled()) {
+                allocator.moveFrame(-1, proc, nfu.currentTime);
+            }
+        } else {
+            // Must evict victim selected by NFU
+            sim.pageReplacements++;
+            const int victimPFN   = nfu.pages[victimIndex].pfn;
+            const bool writeBack  = nfu.pages[victimIndex].dirty;
+            if (writeBack) sim.writeBacks++;
+            latency.majorFault(skipped, writeBack);
+
+            // reuseSlotNFU returns (oldVPN, oldBitstring), and advances to hold 'vpn'
+            const auto oldInfo  = reuseSlotNFU(nfu, victimIndex, vpn);
+            const uint64_t oldVaddr = oldInfo.first << pt.offsetBits;
+
+            out.vpnReplaced     = (int64_t)oldInfo.first;
+            out.victimBitstring = oldInfo.second;
+            recorder.record(FlightEventType::Evict, oldInfo.first, (uint32_t)victimPFN, oldInfo.second,
+                            writeBack ? FLIGHT_DIRTY : 0);
+            if (prefetcher.enabled()) {
+                prefetcher.onEvict(oldInfo.first);
+            }
+            if (caches.enabled()) {
+                caches.invalidateFrame((uint64_t)victimPFN, pt.offsetBits);
+            }
+
+            // Invalidate old mapping in the page table (frees emptied levels with -r)
+            pt.removeMapForVpn2Pfn(oldVaddr);
+
+            // Insert the new mapping
+            mapping = insert(victimPFN);
+            nfuIndex = (size_t)victimIndex;
+            if (allocator.enabled()) {
+                allocator.moveFrame(nfu.pages[nfuIndex].proc, proc, nfu.currentTime);
+            }
+        }
+        nfu.pages[nfuIndex].proc = proc;
+        if (prefetcher.enabled()) {
+            prefetcher.onFault(vpn, prefetchQueue);
+        }
+    }
+
+    // before any prefetch events, so an Evict is always followed by the load that took its frame
+    recorder.record(out.pthit ? FlightEventType::Hit : FlightEventType::Miss, vaddr, (uint32_t)mapping->pfn, proc,
+                    write ? FLIGHT_WRITE : 0);
+
+    if (!prefetchQueue.empty()) {
+        // loading more frames can move the inverted table's frame array
+        installPrefetches(proc);
+        mapping = pt.probeMappedPfn(vaddr);
+    }
+
+    if (write) {
+        mapping->dirty = true;
+        nfu.pages[nfuIndex].dirty = true;
+    }
+
+    out.mapping = mapping;
+    sim.count++;
+    if (caches.enabled()) {
+        caches.access(((uint64_t)mapping->pfn << pt.offsetBits) | pt.getOffset(vaddr));
+    }
+
+    // Remember the page for a following same-page access. The access above
+    // added it to 'accessed' unless it fell on a tick boundary.
+    sim.run.at         = sim.count;
+    sim.run.vpn        = vpn;
+    sim.run.mapping    = mapping;
+    sim.run.nfuIndex   = nfuIndex;
+    sim.run.markedTick = (nfu.currentTime % nfu.interval != 0) ? nfu.ticks : UINT64_MAX;
+    recorder.afterAccesses(1, out.pthit ? 0 : 1, (uint64_t)sim.count);
+    return out;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Loads the pages in prefetchQueue that are not resident yet, as unreferenced
+  pages (NFU bitstring 0, so an unused prefetch is the first page evicted).
+
+  - A free frame is used while there is one (pickVictim decides, so
+    per-process allocation applies to prefetches too).
+  - Otherwise the victim is evicted, unless it was loaded or referenced
+    by this very access: then only pages this access needs would go, and
+    prefetching stops.
+
+  These loads are not demand faults, so they leave the hit / miss /
+  replacement counters alone and are counted in prefetcher.stats.
+───────────────────────────────────────────────────────────────────────────────*/
+void Simulator::installPrefetches(uint8_t proc) {
+    static const uint16_t PREFETCH_BITS = 0;
+
+    for (uint64_t vpn : prefetchQueue) {
+        const uint64_t vaddr = vpn << pt.offsetBits;
+        if (pt.probeMappedPfn(vaddr)) {
+            continue;
+        }
+
+        int frame;
+        int owner = -1; // process the frame came from, -1 for a free frame
+        bool writeBack = false;
+        const int victimIndex = pickVictim(proc);
+        if (victimIndex < 0) {
+            frame = counters.nextFreePFN++;
+            onMissNFU(nfu, vpn, frame, PREFETCH_BITS, false);
+            nfu.pages.back().proc = proc;
+            prefetcher.stats.frames++;
+        } else {
+            if (nfu.pages[victimIndex].lastAccessTime == nfu.currentTime) {
+                break;
+            }
+            frame = nfu.pages[victimIndex].pfn;
+            owner = nfu.pages[victimIndex].proc;
+            writeBack = nfu.pages[victimIndex].dirty;
+            if (writeBack) counters.writeBacks++;
+            const auto oldInfo = reuseSlotNFU(nfu, victimIndex, vpn, PREFETCH_BITS, false);
+            nfu.pages[victimIndex].proc = proc;
+            recorder.record(FlightEventType::Evict, oldInfo.first, (uint32_t)frame, oldInfo.second,
+                            writeBack ? FLIGHT_DIRTY : 0);
+            pt.removeMapForVpn2Pfn(oldInfo.first << pt.offsetBits);
+            if (caches.enabled()) {
+                caches.invalidateFrame((uint64_t)frame, pt.offsetBits);
+            }
+            prefetcher.onEvict(oldInfo.first);
+            prefetcher.stats.evictions++;
+        }
+        if (allocator.enabled()) {
+            allocator.moveFrame(owner, proc, nfu.currentTime);
+        }
+
+        pt.insertMapForVpn2Pfn(vaddr, frame);
+        recorder.record(FlightEventType::Prefetch, vpn, (uint32_t)frame);
+        prefetcher.unused.insert(vpn);
+        prefetcher.stats.issued++;
+        latency.prefetchRead(writeBack);
+    }
+    prefetchQueue.clear();
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Frame for a page proc loads: -1 for the next free frame, else the index
+  in nfu.pages of the page to evict. Without per-process allocation that
+  is a free frame while there is one, then the NFU victim. Pages the
+  allocator cleaned on the way count as write-backs (unless !account).
+───────────────────────────────────────────────────────────────────────────────*/
+int Simulator::pickVictim(uint8_t proc, bool account) {
+    if (!allocator.enabled()) {
+        return isFullNFU(nfu) ? selectVictimNFU(nfu) : -1;
+    }
+
+    const int victimIndex = allocator.pickVictim(nfu, proc, cleaned);
+    for (uint64_t vpn : cleaned) {
+        Map* mapping = pt.probeMappedPfn(vpn << pt.offsetBits);
+        if (mapping) mapping->dirty = false;
+        if (account) {
+            counters.writeBacks++;
+            latency.backgroundWrite();
+        }
+    }
+    cleaned.clear();
+    return victimIndex;
+}
+
+AccessOutcome Simulator::access(uint64_t vaddr, bool write, uint8_t proc) {
+    return accessStep(vaddr, write, proc,
+                      [&]() { return pt.searchMappedPfn(vaddr); },
+                      [&](int frame) { return pt.insertMapForVpn2Pfn(vaddr, frame); });
+}
+
+AccessOutcome Simulator::access(const AddressBatch& batch, size_t i) {
+    const uint64_t vaddr = batch.vaddr[i];
+    return accessStep(vaddr, batch.write[i] != 0, batch.proc[i],
+                      [&]() { return pt.searchMappedPfn(vaddr, batch, i); },
+                      [&](int frame) { return pt.insertMapForVpn2Pfn(vaddr, batch, i, frame); });
+}
+
+void Simulator::accessBatch(const uint64_t* vaddrs, size_t n, AccessOutcome* outcomes) {
+    static const size_t SCRATCH_SIZE = 256;
+    if (scratch.capacity == 0) {
+        scratch.init(pt.numLevels, SCRATCH_SIZE);
+    }
+
+    for (size_t done = 0; done < n; done += scratch.count) {
+        scratch.count = min(n - done, scratch.capacity);
+        copy(vaddrs + done, vaddrs + done + scratch.count, scratch.vaddr.begin());
+        fill(scratch.write.begin(), scratch.write.begin() + scratch.count, 0);
+        fill(scratch.proc.begin(), scratch.proc.begin() + scratch.count, 0);
+        pt.decomposeBatch(scratch);
+
+        for (size_t i = 0; i < scratch.count; i++) {
+            const AccessOutcome out = access(scratch, i);
+            if (outcomes) outcomes[done + i] = out;
+        }
+    }
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  access() without the models: same table, NFU, dirty bit and victim choice,
+  so measurement after it starts from the state a full run would have.
+
+  Counters stay put, which keeps counters.run valid (run.at still equals
+  count), so same-page accesses take the repeat path here as well. The
+  caches only drop an evicted frame's lines and the prefetcher only forgets
+  an evicted or referenced page, so neither is left stale; nothing is
+  prefetched.
+───────────────────────────────────────────────────────────────────────────────*/
+void Simulator::warmAccess(uint64_t vaddr, bool write, uint8_t proc) {
+    SimCounters& sim = counters;
+    const uint64_t vpn = vaddr >> pt.offsetBits;
+
+    if (sim.run.at == sim.count && sim.run.vpn == vpn) {
+        onRepeatHitsNFU(nfu, sim.run.nfuIndex, 1, sim.run.markedTick);
+        if (allocator.enabled()) {
+            allocator.onAccess(proc, 1, nfu.currentTime);
+        }
+        if (write) {
+            sim.run.mapping->dirty = true;
+            nfu.pages[sim.run.nfuIndex].dirty = true;
+        }
+        return;
+    }
+
+    beforeAccessNFU(nfu);
+    if (allocator.enabled()) {
+        allocator.onAccess(proc, 1, nfu.currentTime);
+    }
+
+    Map* mapping = pt.probeMappedPfn(vaddr);
+    size_t nfuIndex;
+    if (mapping && mapping->valid) {
+        nfuIndex = onHitNFU(nfu, vpn);
+        if (!prefetcher.unused.empty()) prefetcher.unused.erase(vpn);
+    } else {
+        if (allocator.enabled()) {
+            allocator.onFault(proc, nfu.currentTime);
+        }
+        const int victimIndex = pickVictim(proc, false);
+        int frame;
+        int owner = -1; // process the frame came from, -1 for a free frame
+        if (victimIndex < 0) {
+            frame = sim.nextFreePFN++;
+            onMissNFU(nfu, vpn, frame);
+            nfuIndex = nfu.pages.size() - 1;
+        } else {
+            frame = nfu.pages[victimIndex].pfn;
+            owner = nfu.pages[victimIndex].proc;
+            const uint64_t oldVpn = reuseSlotNFU(nfu, victimIndex, vpn).first;
+            if (!prefetcher.unused.empty()) prefetcher.unused.erase(oldVpn);
+            if (caches.enabled()) {
+                caches.invalidateFrame((uint64_t)frame, pt.offsetBits);
+            }
+            pt.removeMapForVpn2Pfn(oldVpn << pt.offsetBits);
+            nfuIndex = (size_t)victimIndex;
+        }
+        mapping = pt.insertMapForVpn2Pfn(vaddr, frame);
+        if (allocator.enabled()) {
+            allocator.moveFrame(owner, proc, nfu.currentTime);
+        }
+        nfu.pages[nfuIndex].proc = proc;
+    }
+
+    if (write) {
+        mapping->dirty = true;
+        nfu.pages[nfuIndex].dirty = true;
+    }
+
+    sim.run.at         = sim.count;
+    sim.run.vpn        = vpn;
+    sim.run.mapping    = mapping;
+    sim.run.nfuIndex   = nfuIndex;
+    sim.run.markedTick = (nfu.currentTime % nfu.interval != 0) ? nfu.ticks : UINT64_MAX;
+}
+
+void Simulator::repeatHits(uint64_t count, bool write, uint8_t proc) {
+    // aux holds 16 bits of count, longer runs take several events
+    const uint64_t page = counters.run.vpn << pt.offsetBits;
+    for (uint64_t left = count; left > 0 && recorder.enabled(); left -= min<uint64_t>(left, UINT16_MAX)) {
+        recorder.record(FlightEventType::Repeat, page, (uint32_t)counters.run.mapping->pfn,
+                        (uint16_t)min<uint64_t>(left, UINT16_MAX), write ? FLIGHT_WRITE : 0);
+    }
+    repeatStep(count, write, proc);
+    recorder.afterAccesses(count, 0, (uint64_t)counters.count);
+}
+
+void Simulator::repeatStep(uint64_t count, bool write, uint8_t proc) {
+    const uint64_t ticksBefore = nfu.ticks;
+    onRepeatHitsNFU(nfu, counters.run.nfuIndex, count, counters.run.markedTick);
+    recordTicks(ticksBefore);
+    if (allocator.enabled()) {
+        allocator.onAccess(proc, count, nfu.currentTime);
+    }
+    if (write) {
+        counters.run.mapping->dirty = true;
+        nfu.pages[counters.run.nfuIndex].dirty = true;
+    }
+    latency.translationReuse(count);
+    counters.hits  += count;
+    counters.count += (int64_t)count;
+    counters.run.at = counters.count;
+}
+
+void Simulator::recordTicks(uint64_t ticksBefore) {
+    if (nfu.ticks != ticksBefore) {
+        recorder.record(FlightEventType::Tick, nfu.currentTime, (uint32_t)(nfu.ticks - ticksBefore));
+    }
+}
+
+void Simulator::enableFlightRecorder(uint64_t events, const string& path) {
+    vector<int> levelBits;
+    for (int level = 0; level < pt.numLevels; level++) {
+        levelBits.push_back(__builtin_popcountll(pt.bitmasks[level]));
+    }
+    recorder.init(events, path, levelBits, pt.addressBits);
+    pt.stats.recorder = &recorder;
+}
+
+SimulatorStats Simulator::stats() const {
+    SimulatorStats st;
+    st.pageSize         = pt.pageSizeBytes();
+    st.accesses         = (uint64_t)counters.count;
+    st.hits             = counters.hits;
+    st.misses           = (uint64_t)counters.count - counters.hits;
+    st.pageReplacements = counters.pageReplacements;
+    st.framesAllocated  = counters.framesAllocated;
+    st.writeBacks       = counters.writeBacks;
+    st.tableEntries     = pt.stats.entries;
+    st.tableBytes       = pt.stats.bytes;
+    st.peakEntries      = pt.stats.peakEntries;
+    st.peakBytes        = pt.stats.peakBytes;
+    return st;
+}
+
+size_t sameVpnRun(const PageTable& pt, const AddressBatch& batch, size_t i, size_t end) {
+    if (i == 0 || i >= end) return 0;
+    const uint64_t vpn = batch.vaddr[i - 1] >> pt.offsetBits;
+    const uint8_t proc = batch.proc[i - 1];
+    size_t j = i;
+    while (j < end && (batch.vaddr[j] >> pt.offsetBits) == vpn && batch.proc[j] == proc) {
+        j++;
+    }
+    return j - i;
+}
+
+size_t readAddressBatch(TraceSource& source, const PageTable& pt, AddressBatch& batch, int64_t maxCount) {
+    const size_t want = (maxCount >= 0 && (uint64_t)maxCount < batch.capacity) ? (size_t)maxCount : batch.capacity;
+    p2AddrTr64 mTrace{};
+
+    batch.count = 0;
+    while (batch.count < want && source.next(&mTrace)) {
+        batch.write[batch.count] = isWriteRecord(mTrace);
+        batch.proc[batch.count]  = mTrace.proc;
+        batch.vaddr[batch.count++] = mTrace.addr;
+    }
+    pt.decomposeBatch(batch);
+    return batch.count;
+}
+
+bool openTraceForRun(const vector<string>& traceFiles, Simulator& simulator, const RunOptions& opts,
+                     TraceSource& source) {
+    if (!source.open(traceFiles, simulator.pt, opts.filter)) {
+        return false;
+    }
+
+    if (!opts.restoreFile.empty()) {
+        uint64_t traceOffset = 0;
+        if (!loadCheckpoint(opts.restoreFile, simulator, opts.filter, traceOffset)) {
+            return false;
+        }
+        if (!source.seek(traceOffset)) {
+            cerr << "Checkpoint " << opts.restoreFile << " is past the end of the trace" << endl;
+            return false;
+        }
+    }
+    return true;
+}
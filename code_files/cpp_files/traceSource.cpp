@@ -0,0 +1,351 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "traceSource.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static const size_t READ_AHEAD_RECORDS = 4096; // records per fread, per file
+
+bool TraceSource::open(const vector<string>& paths, const PageTable& pt, const TraceFilter& filter_) {
+    close();
+    wide       = pt.addressBits > 32;
+    recordSize = wide ? (long)sizeof(p2AddrTr64) : (long)sizeof(p2AddrTr);
+    filter     = filter_;
+    filtering  = filter.active();
+    totalKnown = !filtering;
+
+    inputs.resize(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        Input& in = inputs[i];
+        in.f = fopen(paths[i].c_str(), "rb");
+        if (!in.f) {
+            cerr << "Unable to open " << paths[i] << endl;
+            close();
+            return false;
+        }
+        fseeko(in.f, 0, SEEK_END);
+        total += (uint64_t)ftello(in.f) / (uint64_t)recordSize;
+        fseeko(in.f, 0, SEEK_SET);
+        in.buf.resize(READ_AHEAD_RECORDS * (size_t)recordSize);
+    }
+
+    buildHeap();
+    return true;
+}
+
+void TraceSource::close() {
+    for (Input& in : inputs) {
+        if (in.f) fclose(in.f);
+    }
+    inputs.clear();
+    heap.clear();
+    consumed = 0;
+    total = 0;
+}
+
+bool TraceSource::refill(Input& in) {
+    while (true) {
+        size_t n = fread(in.buf.data(), (size_t)recordSize, READ_AHEAD_RECORDS, in.f);
+        const bool atEnd = n == 0;
+        if (filtering) n = filterBlock(in.buf.data(), n);
+        in.pos = 0;
+        in.len = n * (size_t)recordSize;
+        if (n > 0 || atEnd) return n > 0;
+        // the whole block was rejected, read on
+    }
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Filtering a block: every record is copied to the next free slot and the
+  slot only advances if the record is accepted, so rejected records cost
+  a few loads and a copy with no branch to mispredict, however the
+  accepted ones are scattered. Fields are read straight from the raw
+  records; only the address needs the trace's byte order.
+───────────────────────────────────────────────────────────────────────────────*/
+template <typename Record>
+static size_t compactAccepted(unsigned char* block, size_t records, const TraceFilter& filter) {
+    size_t kept = 0;
+    for (size_t i = 0; i < records; i++) {
+        const unsigned char* raw = block + i * sizeof(Record);
+        decltype(Record::addr) addr;
+        memcpy(&addr, raw + offsetof(Record, addr), sizeof(addr));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        addr = sizeof(addr) == 8 ? __builtin_bswap64(addr) : __builtin_bswap32(addr);
+#endif
+        const unsigned accept = filter.accepts(addr, raw[offsetof(Record, reqtype)], raw[offsetof(Record, proc)]);
+        memmove(block + kept * sizeof(Record), raw, sizeof(Record));
+        kept += accept;
+    }
+    return kept;
+}
+
+size_t TraceSource::filterBlock(unsigned char* block, size_t records) const {
+    return wide ? compactAccepted<p2AddrTr64>(block, records, filter)
+                : compactAccepted<p2AddrTr>(block, records, filter);
+}
+
+uint64_t TraceSource::totalRecords() {
+    if (totalKnown) {
+        return total;
+    }
+
+    // one pass over every file with a buffer of its own, leaving the stream where it was
+    vector<unsigned char> block(READ_AHEAD_RECORDS * (size_t)recordSize);
+    total = 0;
+    for (Input& in : inputs) {
+        const off_t at = ftello(in.f);
+        fseeko(in.f, 0, SEEK_SET);
+        size_t n;
+        while ((n = fread(block.data(), (size_t)recordSize, READ_AHEAD_RECORDS, in.f)) > 0) {
+            total += filterBlock(block.data(), n);
+        }
+        clearerr(in.f);
+        fseeko(in.f, at, SEEK_SET);
+    }
+    totalKnown = true;
+    return total;
+}
+
+void TraceSource::decode(Input& in, p2AddrTr64* rec) {
+    const unsigned char* raw = in.buf.data() + in.pos;
+    in.pos += (size_t)recordSize;
+
+    if (wide) {
+        memcpy(rec, raw, sizeof(p2AddrTr64));
+        ConvertAddress64(rec);
+        return;
+    }
+
+    p2AddrTr narrow;
+    memcpy(&narrow, raw, sizeof(p2AddrTr));
+    ConvertAddress(&narrow);
+    rec->addr    = narrow.addr;
+    rec->reqtype = narrow.reqtype;
+    rec->size    = narrow.size;
+    rec->attr    = narrow.attr;
+    rec->proc    = narrow.proc;
+    rec->time    = narrow.time;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Merge heap: a binary min-heap of input indices keyed on each input's next
+  record. Inputs leave the heap once they run dry.
+───────────────────────────────────────────────────────────────────────────────*/
+bool TraceSource::heapBefore(size_t a, size_t b) const {
+    const uint32_t ta = inputs[a].head.time;
+    const uint32_t tb = inputs[b].head.time;
+    return ta < tb || (ta == tb && a < b);
+}
+
+void TraceSource::siftDown(size_t slot) {
+    const size_t n = heap.size();
+    while (true) {
+        const size_t left = 2 * slot + 1;
+        if (left >= n) break;
+        size_t first = left;
+        if (left + 1 < n && heapBefore(heap[left + 1], heap[left])) {
+            first = left + 1;
+        }
+        if (!heapBefore(heap[first], heap[slot])) break;
+        swap(heap[first], heap[slot]);
+        slot = first;
+    }
+}
+
+void TraceSource::buildHeap() {
+    heap.clear();
+    if (inputs.size() < 2) {
+        return; // a single file is read straight through
+    }
+    for (size_t i = 0; i < inputs.size(); i++) {
+        Input& in = inputs[i];
+        if (in.pos < in.len || refill(in)) {
+            decode(in, &in.head);
+            heap.push_back(i);
+        }
+    }
+    for (size_t slot = heap.size() / 2; slot-- > 0;) {
+        siftDown(slot);
+    }
+}
+
+int TraceSource::nextMerged(p2AddrTr64* rec) {
+    if (heap.empty()) {
+        return 0;
+    }
+
+    const size_t top = heap[0];
+    Input& in = inputs[top];
+    *rec = in.head;
+    consumed++;
+
+    // replace the top with the same file's next record, or drop the file
+    if (in.pos < in.len || refill(in)) {
+        decode(in, &in.head);
+    } else {
+        heap[0] = heap.back();
+        heap.pop_back();
+    }
+    if (!heap.empty()) {
+        siftDown(0);
+    }
+    return 1;
+}
+
+uint64_t TraceSource::skip(uint64_t count) {
+    if (inputs.size() != 1) {
+        p2AddrTr64 rec;
+        uint64_t skipped = 0;
+        while (skipped < count && nextMerged(&rec)) {
+            skipped++;
+        }
+        return skipped;
+    }
+
+    Input& in = inputs[0];
+    if (filtering) {
+        // accepted records can't be found without reading them: go a block at a time
+        uint64_t skipped = 0;
+        while (skipped < count && (in.pos < in.len || refill(in))) {
+            const uint64_t take = min<uint64_t>(count - skipped, (in.len - in.pos) / (size_t)recordSize);
+            in.pos += (size_t)take * (size_t)recordSize;
+            skipped += take;
+        }
+        consumed += skipped;
+        return skipped;
+    }
+
+    // one file: use what is buffered, seek over the rest
+    if (consumed + count > total) {
+        count = total - consumed;
+    }
+    const uint64_t buffered = (in.len - in.pos) / (size_t)recordSize;
+    if (count <= buffered) {
+        in.pos += (size_t)count * (size_t)recordSize;
+    } else {
+        fseeko(in.f, (off_t)((count - buffered) * (uint64_t)recordSize), SEEK_CUR);
+        in.pos = in.len = 0;
+    }
+    consumed += count;
+    return count;
+}
+
+bool TraceSource::seek(uint64_t offset) {
+    const uint64_t target = offset / (uint64_t)recordSize;
+    if (totalKnown && target > total) {
+        return false;
+    }
+
+    for (Input& in : inputs) {
+        fseeko(in.f, 0, SEEK_SET);
+        in.pos = in.len = 0;
+    }
+    consumed = 0;
+    buildHeap();
+    return skip(target) == target;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Filter options
+───────────────────────────────────────────────────────────────────────────────*/
+
+// splits "a,b,c" into fields, false if any is empty
+static bool splitList(const string& spec, vector<string>& fields) {
+    fields.clear();
+    size_t pos = 0;
+    while (true) {
+        const size_t comma = spec.find(',', pos);
+        fields.push_back(spec.substr(pos, comma == string::npos ? string::npos : comma - pos));
+        if (fields.back().empty()) return false;
+        if (comma == string::npos) return true;
+        pos = comma + 1;
+    }
+}
+
+// a number 0..255, decimal or 0x hex
+static bool parseByte(const string& field, unsigned& value) {
+    char* end = nullptr;
+    const unsigned long parsed = strtoul(field.c_str(), &end, 0);
+    if (field.empty() || *end != '\0' || field[0] == '-' || parsed > 255) return false;
+    value = (unsigned)parsed;
+    return true;
+}
+
+bool parseProcFilter(const string& spec, TraceFilter& filter) {
+    vector<string> fields;
+    if (!splitList(spec, fields)) return false;
+    if (!filter.byProc) {
+        memset(filter.procOk, 0, sizeof(filter.procOk));
+        filter.byProc = true;
+    }
+    for (const string& field : fields) {
+        unsigned proc;
+        if (field.find_first_not_of("0123456789") != string::npos || !parseByte(field, proc)) return false;
+        filter.procOk[proc] = 1;
+    }
+    return true;
+}
+
+bool parseReqtypeFilter(const string& spec, TraceFilter& filter) {
+    static const struct {
+        const char* name;
+        vector<uint8_t> types;
+    } NAMES[] = {
+        {"fetch", {FETCH}},
+        {"read", {MEMREAD}},
+        {"readinv", {MEMREADINV}},
+        {"write", {MEMWRITE}},
+        {"ioread", {IOREAD}},
+        {"iowrite", {IOWRITE}},
+        {"data", {MEMREAD, MEMREADINV, MEMWRITE}},
+        {"io", {IOREAD, IOWRITE}},
+    };
+
+    vector<string> fields;
+    if (!splitList(spec, fields)) return false;
+    if (!filter.byType) {
+        memset(filter.typeOk, 0, sizeof(filter.typeOk));
+        filter.byType = true;
+    }
+    for (const string& field : fields) {
+        bool named = false;
+        for (const auto& entry : NAMES) {
+            if (field != entry.name) continue;
+            for (uint8_t type : entry.types) filter.typeOk[type] = 1;
+            named = true;
+        }
+        unsigned type;
+        if (!named) {
+            if (!parseByte(field, type)) return false;
+            filter.typeOk[type] = 1;
+        }
+    }
+    return true;
+}
+
+bool parseAddrRange(const string& spec, TraceFilter& filter) {
+    const size_t colon = spec.find(':');
+    if (colon == string::npos) return false;
+    uint64_t bounds[2];
+    const string fields[2] = {spec.substr(0, colon), spec.substr(colon + 1)};
+    for (int i = 0; i < 2; i++) {
+        string digits = fields[i];
+        if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) digits = digits.substr(2);
+        if (digits.empty() || digits.size() > 16 || digits.find_first_not_of("0123456789abcdefABCDEF") != string::npos) {
+            return false;
+        }
+        bounds[i] = strtoull(digits.c_str(), nullptr, 16);
+    }
+    if (bounds[1] <= bounds[0]) return false;
+    filter.addrFirst = bounds[0];
+    filter.addrLast = bounds[1] - 1;
+    filter.byAddr = true;
+    return true;
+}
@@ -0,0 +1,174 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#include "tune.h"
+#include "traceSource.h"
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+// Accesses to one page in a row, by one process: the first one walks the
+// table, the rest are served by the simulator's same-page fast path
+struct TuneRun {
+    uint64_t vaddr; // address of the first access
+    uint32_t repeats; // accesses after the first
+    uint8_t write; // bit 0: the first access writes, bit 1: one of the repeats does
+    uint8_t proc;
+};
+
+// How one split did
+struct TuneResult {
+    vector<int> levelBits;
+    uint64_t peakBytes = 0;
+    uint64_t bytes = 0;
+    uint64_t entries = 0;
+    double avgWalk = 0;
+};
+
+// appends every split of bits into at most depthLeft more levels (1..30 bits each) to out
+static void enumerateSplits(int bits, int depthLeft, vector<int>& prefix, vector<vector<int>>& out) {
+    if (bits == 0) {
+        out.push_back(prefix);
+        return;
+    }
+    if (depthLeft == 0 || bits > depthLeft * 30) return;
+    for (int level = 1; level <= min(bits, 30); level++) {
+        prefix.push_back(level);
+        enumerateSplits(bits - level, depthLeft - 1, prefix, out);
+        prefix.pop_back();
+    }
+}
+
+// counts the splits enumerateSplits would produce, stopping once past limit
+static uint64_t countSplits(int bits, int depthLeft, uint64_t limit) {
+    if (bits == 0) return 1;
+    if (depthLeft == 0 || bits > depthLeft * 30) return 0;
+    uint64_t total = 0;
+    for (int level = 1; level <= min(bits, 30) && total <= limit; level++) {
+        total += countSplits(bits - level, depthLeft - 1, limit);
+    }
+    return total;
+}
+
+static TuneResult evaluate(const SimulatorConfig& config, const vector<TuneRun>& runs, uint64_t accesses) {
+    unique_ptr<Simulator> sim(new Simulator);
+    sim->init(config);
+    const uint64_t depth = config.levelBits.size();
+    uint64_t levelsRead = 0;
+    for (const TuneRun& run : runs) {
+        levelsRead += depth - sim->access(run.vaddr, (run.write & 1) != 0, run.proc).walkSkipped;
+        if (run.repeats > 0) {
+            sim->repeatHits(run.repeats, (run.write & 2) != 0, run.proc);
+        }
+    }
+
+    TuneResult result;
+    result.levelBits = config.levelBits;
+    result.peakBytes = sim->pt.stats.peakBytes;
+    result.bytes = sim->pt.stats.bytes;
+    result.entries = sim->pt.countEntries(&sim->pt);
+    result.avgWalk = accesses ? (double)levelsRead / (double)accesses : 0;
+    return result;
+}
+
+static void tuneWorker(const SimulatorConfig& base, const vector<vector<int>>& splits, const vector<TuneRun>& runs,
+                       uint64_t accesses, atomic<size_t>& next, vector<TuneResult>& results) {
+    for (size_t k = next.fetch_add(1); k < splits.size(); k = next.fetch_add(1)) {
+        SimulatorConfig config = base;
+        config.levelBits = splits[k];
+        results[k] = evaluate(config, runs, accesses);
+    }
+}
+
+int runTune(const vector<string>& traceFiles, const SimulatorConfig& base, int64_t numAccesses,
+            const TraceFilter& filter, const TuneOptions& opts) {
+    int vpnBits = 0;
+    for (int bits : base.levelBits) vpnBits += bits;
+
+    const uint64_t candidates = countSplits(vpnBits, opts.maxDepth, MAX_TUNE_CANDIDATES);
+    if (candidates > MAX_TUNE_CANDIDATES) {
+        cerr << "More than " << MAX_TUNE_CANDIDATES << " level splits of " << vpnBits
+             << " bits, lower --max-depth" << endl;
+        return 1;
+    }
+    vector<vector<int>> splits;
+    vector<int> prefix;
+    enumerateSplits(vpnBits, opts.maxDepth, prefix, splits);
+
+    // the command line split only sets the record width and the page size here
+    PageTable layout;
+    layout.initFromLevelBits(base.levelBits, base.addressBits);
+    TraceSource source;
+    if (!source.open(traceFiles, layout, filter)) {
+        return 1;
+    }
+
+    vector<TuneRun> runs;
+    uint64_t accesses = 0;
+    p2AddrTr64 rec{};
+    while ((numAccesses <= 0 || (int64_t)accesses < numAccesses) && source.next(&rec)) {
+        const bool write = isWriteRecord(rec);
+        if (!runs.empty()) {
+            TuneRun& last = runs.back();
+            if ((last.vaddr >> layout.offsetBits) == (rec.addr >> layout.offsetBits) && last.proc == rec.proc &&
+                last.repeats < UINT32_MAX) {
+                last.repeats++;
+                if (write) last.write |= 2;
+                accesses++;
+                continue;
+            }
+        }
+        runs.push_back({rec.addr, 0, (uint8_t)(write ? 1 : 0), rec.proc});
+        accesses++;
+    }
+    source.close();
+
+    SimulatorConfig config = base;
+    config.caches.clear();
+    config.latencyModel = false;
+
+    vector<TuneResult> results(splits.size());
+    atomic<size_t> next{0};
+    vector<thread> pool;
+    const int threads = (int)min<size_t>((size_t)opts.threads, splits.size());
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back(tuneWorker, cref(config), cref(splits), cref(runs), accesses, ref(next), ref(results));
+    }
+    for (thread& worker : pool) worker.join();
+
+    /*───────────────────────────────────────────────────────────────────────────
+      Pareto frontier: shortest walk first (fewest bytes, then entries, among
+      equal walks), a split is kept if it needs fewer bytes than every split
+      kept before it.
+    ───────────────────────────────────────────────────────────────────────────*/
+    sort(results.begin(), results.end(), [](const TuneResult& a, const TuneResult& b) {
+        if (a.avgWalk != b.avgWalk) return a.avgWalk < b.avgWalk;
+        if (a.peakBytes != b.peakBytes) return a.peakBytes < b.peakBytes;
+        return a.entries < b.entries;
+    });
+
+    printf("level_bits,levels,avg_walk,peak_bytes,table_bytes,entries\n");
+    uint64_t bestBytes = UINT64_MAX;
+    for (const TuneResult& result : results) {
+        if (result.peakBytes >= bestBytes) continue;
+        bestBytes = result.peakBytes;
+        if (opts.walkBudget >= 0 && result.avgWalk > opts.walkBudget) break;
+
+        string bits;
+        for (int b : result.levelBits) {
+            if (!bits.empty()) bits += ' ';
+            bits += to_string(b);
+        }
+        printf("\"%s\",%zu,%.4f,%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n", bits.c_str(), result.levelBits.size(),
+               result.avgWalk, result.peakBytes, result.bytes, result.entries);
+    }
+
+    return 0;
+}
@@ -13,6 +13,13 @@ uint32_t swap_endian(uint32_t num)
   ((num >> 8) & 0x0000ff00) | ((num >> 24) & 0x000000ff) );
 }
 
+/* 64-bit version of swap_endian, for p2AddrTr64 addresses */
+uint64_t swap_endian64(uint64_t num)
+{
+  return(((uint64_t) swap_endian((uint32_t) num) << 32) |
+         swap_endian((uint32_t) (num >> 32)));
+}
+
 /* determine if system is big- or little- endian */
 ENDIAN endian()
 {
@@ -69,6 +76,41 @@ int NextAddress(FILE *trace_file, p2AddrTr *addr_ptr) {
   return readN;    
 }
 
+/* void ConvertAddress(p2AddrTr *Addr)
+ * Convert a record read without NextAddress (e.g. in bulk) from the
+ * little-endian trace format to host byte order.
+ */
+void ConvertAddress(p2AddrTr *addr_ptr) {
+
+  static ENDIAN byte_order = UNKNOWN;	/* don't know machine format */
+
+  if (byte_order == UNKNOWN) {
+    byte_order = endian();
+  }
+
+  if (byte_order == BIG) {
+    addr_ptr->addr = swap_endian(addr_ptr->addr);
+    addr_ptr->time = swap_endian(addr_ptr->time);
+  }
+}
+
+/* void ConvertAddress64(p2AddrTr64 *Addr)
+ * Same as ConvertAddress, for p2AddrTr64 records.
+ */
+void ConvertAddress64(p2AddrTr64 *addr_ptr) {
+
+  static ENDIAN byte_order = UNKNOWN;	/* don't know machine format */
+
+  if (byte_order == UNKNOWN) {
+    byte_order = endian();
+  }
+
+  if (byte_order == BIG) {
+    addr_ptr->addr = swap_endian64(addr_ptr->addr);
+    addr_ptr->time = swap_endian(addr_ptr->time);
+  }
+}
+
 /* void AddressDecoder(p2AddrTr *addr_ptr, FILE *out)
  * Decode a Pentium II BYU address and print to the specified
  * file handle (opened by fopen in write mode)
@@ -0,0 +1,41 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// A block of virtual addresses and their per-level VPN indices / offsets,
+// stored as structure of arrays: rows[level][i] is access i's index at level.
+// Filled by PageTable::decomposeBatch, consumed by the batch-aware walks.
+struct AddressBatch {
+    size_t capacity = 0; // accesses the buffers can hold
+    size_t count = 0; // accesses currently held
+    vector<uint64_t> vaddr; // virtual addresses
+    vector<uint64_t> offset; // page offset of each address
+    vector<uint8_t> write; // 1 if the access writes its page (MEMWRITE record)
+    vector<uint8_t> proc; // process making the access (trace proc field)
+    vector<uint32_t> pieceStorage; // numLevels rows of capacity indices each
+    vector<uint32_t*> rows; // rows[level] points at that level's indices
+
+    // sizes the buffers for numLevels levels and capacity accesses
+    void init(int numLevels, size_t capacity_) {
+        capacity = capacity_;
+        count = 0;
+        vaddr.assign(capacity, 0);
+        offset.assign(capacity, 0);
+        write.assign(capacity, 0);
+        proc.assign(capacity, 0);
+        pieceStorage.assign((size_t)numLevels * capacity, 0);
+        rows.resize(numLevels);
+        for (int level = 0; level < numLevels; level++) {
+            rows[level] = pieceStorage.data() + (size_t)level * capacity;
+        }
+    }
+};
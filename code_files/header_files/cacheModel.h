@@ -0,0 +1,89 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Which line a full cache set gives up on a miss
+enum class CacheReplacement {
+    LRU, // least recently used
+    FIFO, // oldest fill
+    Random, // any line, uniformly
+};
+
+// Geometry and policy of one cache level
+struct CacheLevelConfig {
+    uint64_t sizeBytes = 32 * 1024; // total capacity
+    unsigned ways = 8; // lines per set
+    unsigned lineBytes = 64; // bytes per line, a power of two
+    CacheReplacement replacement = CacheReplacement::LRU;
+};
+
+// Parses "SIZE:WAYS:LINE[:lru|fifo|random]" (SIZE may end in K or M, e.g.
+// "32K:8:64:lru"). The set count must come out a power of two.
+// Returns false if malformed.
+bool parseCacheSpec(const string& spec, CacheLevelConfig& config);
+
+/*───────────────────────────────────────────────────────────────────────────────
+  One set-associative, physically indexed and tagged cache level.
+
+  Tag array layout: one flat vector, set s owning the ways slots starting at
+  s * ways, so a lookup reads one short contiguous run (8 ways of 8 bytes is
+  a single host cache line). Each slot holds the full line address. Ways
+  are kept in recency order (LRU) or fill order (FIFO / Random), newest
+  first, with empty slots at the end, so no separate age array is needed.
+───────────────────────────────────────────────────────────────────────────────*/
+struct CacheLevel {
+    static constexpr uint64_t EMPTY = UINT64_MAX; // slot holding no line
+
+    unsigned ways = 0;
+    unsigned lineShift = 0; // log2(lineBytes)
+    uint64_t setMask = 0; // sets - 1
+    CacheReplacement replacement = CacheReplacement::LRU;
+    vector<uint64_t> tags; // sets * ways line addresses
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL; // xorshift state for Random
+
+    void init(const CacheLevelConfig& config);
+
+    // Looks up the line holding paddr; on a miss the line is filled.
+    // Returns true on a hit.
+    bool access(uint64_t paddr);
+
+    // Drops every line of [base, base + bytes), base and bytes multiples of the line size
+    void invalidate(uint64_t base, uint64_t bytes);
+
+private:
+    void removeWay(uint64_t* set, unsigned way); // empties a slot, keeping the filled ones in front
+};
+
+// L1, L2, ... looked up in order until one hits; every level that missed
+// is filled. Empty (disabled) unless configured.
+struct CacheHierarchy {
+    vector<CacheLevel> levels; // levels[0] is L1
+
+    void init(const vector<CacheLevelConfig>& configs);
+    bool enabled() const { return !levels.empty(); }
+
+    void access(uint64_t paddr) {
+        for (CacheLevel& level : levels) {
+            if (level.access(paddr)) return;
+        }
+    }
+
+    // Drops the lines of a frame that is about to hold another page, whose
+    // physical addresses would otherwise hit on the old page's data
+    void invalidateFrame(uint64_t pfn, unsigned offsetBits) {
+        for (CacheLevel& level : levels) {
+            level.invalidate(pfn << offsetBits, 1ull << offsetBits);
+        }
+    }
+};
@@ -0,0 +1,25 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include "pageTable.h"
+#include "simulation.h"
+
+using namespace std;
+
+// Writes the whole simulator state (page table, NFU state, counters and the
+// trace file offset to resume from, under the given trace filter) to a
+// binary checkpoint file.
+// Returns false (after printing why) if the file cannot be written.
+bool saveCheckpoint(const string& path, const Simulator& simulator, const TraceFilter& filter, uint64_t traceOffset);
+
+// Loads a checkpoint into simulator, which must be freshly initialized with
+// the same config (levels, address width, backend, frames and interval) and
+// trace filter as the run that wrote the checkpoint.
+// Returns false (after printing why) on a missing, corrupt or mismatched file.
+bool loadCheckpoint(const string& path, Simulator& simulator, const TraceFilter& filter, uint64_t& traceOffset);
@@ -0,0 +1,39 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "simulation.h"
+
+using namespace std;
+
+// Applies one --compare spec to config: comma separated settings among
+// f=FRAMES, b=INTERVAL, t=radix|inverted, r (reclaim levels), c=TOL
+// (clean-first NFU with tolerance TOL), a=ALLOC (--alloc spec) and
+// s=FILL (sparse interior levels up to FILL percent full), e.g.
+// "f=30,b=5,t=inverted". Settings left out (all of them for an empty
+// spec) keep config's value.
+// Returns false if the spec is malformed.
+bool parseCompareSpec(const string& spec, SimulatorConfig& config);
+
+/*───────────────────────────────────────────────────────────────────────────────
+  -l compare: runs one simulator per spec in lockstep over a single pass of
+  the trace. Every batch is read and decomposed once and then fed to each
+  instance, so the decode and VPN split cost is paid once for K configs.
+  All instances share the command line's level bits and address width (the
+  decomposition depends on them); each spec overrides the rest of base.
+
+  Prints CSV: a row for every access whose outcome (hit, free frame miss,
+  or eviction of some victim) is not the same in all instances, then one
+  row per config with its totals, how many accesses its outcome differed
+  from at least one other config's and the first of them.
+
+  Returns 0 on success, 1 if the trace cannot be opened.
+───────────────────────────────────────────────────────────────────────────────*/
+int runCompare(const vector<string>& traceFiles, const SimulatorConfig& base, const vector<string>& specs,
+               int64_t numAccesses, const TraceFilter& filter);
@@ -0,0 +1,91 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "pageTable.h"
+
+using namespace std;
+
+// One node of the concurrent radix tree. Interior nodes hold child pointers,
+// leaf nodes packed page table entries (see ConcurrentPageTable).
+struct ConcurrentLevel {
+    const unsigned entryCount; // entries at this level
+    const unsigned depth; // 0 for the root
+    atomic<ConcurrentLevel*>* children = nullptr; // interior levels, null slots until installed
+    atomic<uint64_t>* entries = nullptr; // leaf levels, 0 = not mapped
+
+    ConcurrentLevel(unsigned entryCount_, unsigned depth_, bool isLeaf);
+    ~ConcurrentLevel();
+
+    ConcurrentLevel(const ConcurrentLevel&) = delete;
+    ConcurrentLevel& operator=(const ConcurrentLevel&) = delete;
+};
+
+// What translate() did
+enum class ConcurrentOutcome {
+    Hit, // the page was mapped
+    Installed, // this thread mapped it
+    LostRace, // another thread mapped it between this thread's lookup and install
+};
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Radix page table that any number of threads (CPUs sharing one address
+  space) can walk and fill at the same time, without locks.
+
+  - Child levels are installed with a compare-and-swap on the parent's
+    atomic slot. The thread that loses the race frees the level it built
+    and continues down the winner's.
+  - Leaf entries are one 64-bit word each: VALID | DIRTY | pfn. A page is
+    mapped with a compare-and-swap from 0, so exactly one thread's frame
+    ends up in the entry; a write sets DIRTY with fetch_or.
+  - Lookups are plain acquire loads, they never write shared memory (a
+    write to an already dirty page included).
+
+  Levels are only freed with the whole table: unlinking one while other
+  threads may be walking through it would need deferred reclamation
+  (epochs or hazard pointers), which the simulation has no use for since
+  this table has no replacement. It uses the level split of an existing
+  PageTable, so addresses decompose exactly as in the single-threaded
+  simulator.
+───────────────────────────────────────────────────────────────────────────────*/
+struct ConcurrentPageTable {
+    static const uint64_t VALID = 1ull << 63; // entry maps a frame
+    static const uint64_t DIRTY = 1ull << 62; // page written since it was mapped
+    static const uint64_t PFN_MASK = 0xFFFFFFFFull; // frame number bits
+
+    int numLevels = 0;
+    vector<unsigned> entryCount; // per level, as in the layout's PageTable
+    vector<uint64_t> bitmasks;
+    vector<unsigned> shifts;
+    ConcurrentLevel* root = nullptr;
+    atomic<uint64_t> nodes{0}; // levels allocated (losing CAS attempts excluded)
+    atomic<uint64_t> bytes{0}; // bytes those levels hold
+
+    ConcurrentPageTable() = default;
+    ConcurrentPageTable(const ConcurrentPageTable&) = delete;
+    ConcurrentPageTable& operator=(const ConcurrentPageTable&) = delete;
+    ~ConcurrentPageTable() { delete root; }
+
+    // Copies layout's level split and allocates the root. Not thread-safe.
+    void init(const PageTable& layout);
+
+    // Looks vaddr up; returns true and its frame in pfn if mapped
+    bool lookup(uint64_t vaddr, uint32_t& pfn) const;
+
+    // Translates vaddr, mapping it to a frame taken from nextFrame if it is
+    // not mapped yet (a lost race still consumes one). write marks it dirty.
+    // pfn receives the page's frame.
+    ConcurrentOutcome translate(uint64_t vaddr, bool write, atomic<uint32_t>& nextFrame, uint32_t& pfn);
+
+    // Counts the mapped pages. Only meaningful while no thread is translating.
+    uint64_t countMapped() const;
+
+private:
+    ConcurrentLevel* ensureChild(ConcurrentLevel* node, unsigned index);
+};
@@ -0,0 +1,138 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <csignal>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// What a FlightEvent records
+enum class FlightEventType : uint8_t {
+    Hit = 1, // addr: vaddr, pfn: its frame, aux: proc
+    Miss, // addr: vaddr, pfn: the frame it was mapped to, aux: proc
+    Evict, // addr: victim VPN, pfn: its frame, aux: its NFU bitstring; precedes the Miss that took the frame
+    Repeat, // addr: start of the page, pfn: its frame, aux: accesses to the previous access's page served in one step
+    Tick, // addr: NFU virtual time, pfn: aging ticks since the previous Tick event
+    Prefetch, // addr: VPN, pfn: the frame it was loaded into
+    TableAlloc, // addr: bytes, pfn: entries a page table array or node took
+    TableFree, // addr: bytes, pfn: entries it gave back
+};
+
+// FlightEvent.flags bits
+static const uint8_t FLIGHT_WRITE = 1; // Hit / Miss / Repeat: the access (one of them) writes
+static const uint8_t FLIGHT_DIRTY = 2; // Evict: the victim was written back
+
+// One compact binary event, 16 bytes
+struct FlightEvent {
+    uint64_t addr;
+    uint32_t pfn;
+    uint16_t aux;
+    FlightEventType type;
+    uint8_t flags;
+};
+
+// Why a dump was written
+enum class FlightDumpReason : uint8_t {
+    Exit = 1,
+    Signal, // SIGUSR1
+    Trigger, // the fault rate crossed --flight-trigger
+};
+
+// A dump read back by readFlightDump
+struct FlightDump {
+    FlightDumpReason reason = FlightDumpReason::Exit;
+    unsigned addressBits = 32;
+    vector<int> levelBits;
+    uint64_t accessCount = 0; // accesses simulated when the dump was written
+    uint64_t recorded = 0; // events recorded in the whole run so far (older ones were overwritten)
+    vector<FlightEvent> events; // oldest first
+};
+
+// Set by the SIGUSR1 handler, polled by every recorder after each access
+extern volatile sig_atomic_t flightDumpRequested;
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Flight recorder: a fixed-size ring of the most recent simulation events
+  (accesses, faults, evictions, NFU ticks, table allocations), so a run
+  that goes wrong late can be looked at without logging all of it.
+
+  Recording is a store of 16 bytes into a power-of-two ring and an index
+  increment: no branches on the fill level, no allocation, nothing written
+  out. A dump writes the ring, oldest event first, to a binary file that
+  frdecode prints in the -l log formats. It happens:
+
+  - when a window of triggerWindow accesses reaches triggerFaults faults
+    (the first such window only: it marks where a fault storm started);
+  - on SIGUSR1, after the access in progress (every signal gives a dump);
+  - when the recorder is destroyed, if dumpAtExit is set.
+
+  Each dump replaces the file.
+───────────────────────────────────────────────────────────────────────────────*/
+struct FlightRecorder {
+    vector<FlightEvent> ring; // empty when off
+    uint64_t mask = 0; // ring.size() - 1
+    uint64_t head = 0; // events recorded so far, ring[head & mask] is the next slot
+    string path; // where dumps go
+    unsigned addressBits = 32; // the table's geometry, so frdecode can split addresses
+    vector<int> levelBits;
+    bool dumpAtExit = false;
+    uint64_t triggerFaults = 0; // 0: no fault rate trigger
+    uint64_t triggerWindow = 0;
+    uint64_t accessCount = 0; // accesses simulated so far (a restored run's included)
+    uint64_t windowAccesses = 0; // in the current trigger window
+    uint64_t windowFaults = 0;
+    bool triggered = false; // the trigger has fired
+    uint64_t dumps = 0; // dumps written
+
+    FlightRecorder() = default;
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+    ~FlightRecorder();
+
+    // Turns recording on with room for events (rounded up to a power of two)
+    void init(uint64_t events, const string& path_, const vector<int>& levelBits_, unsigned addressBits_);
+    bool enabled() const { return !ring.empty(); }
+
+    void record(FlightEventType type, uint64_t addr, uint32_t pfn, uint16_t aux = 0, uint8_t flags = 0) {
+        if (ring.empty()) return;
+        FlightEvent& event = ring[head++ & mask];
+        event.addr = addr;
+        event.pfn = pfn;
+        event.aux = aux;
+        event.type = type;
+        event.flags = flags;
+    }
+
+    // count accesses just finished, faults of them faulted, total simulated
+    // so far: advances the trigger window and writes any dump that is due
+    void afterAccesses(uint64_t count, uint64_t faults, uint64_t total) {
+        if (ring.empty()) return;
+        accessCount = total;
+        if (triggerFaults > 0 && !triggered) advanceTrigger(count, faults);
+        if (flightDumpRequested) {
+            flightDumpRequested = 0;
+            dump(FlightDumpReason::Signal);
+        }
+    }
+
+    // Writes the ring to path. Returns false (after printing why) if it can't.
+    bool dump(FlightDumpReason reason);
+
+private:
+    void advanceTrigger(uint64_t count, uint64_t faults);
+};
+
+// Parses "FAULTS:WINDOW" (FAULTS <= WINDOW, both positive). Returns false if malformed.
+bool parseFlightTrigger(const string& spec, uint64_t& faults, uint64_t& window);
+
+// Installs the SIGUSR1 handler that requests a dump
+void installFlightSignal();
+
+// Reads a dump written by FlightRecorder::dump. Returns false (after printing why) on failure.
+bool readFlightDump(const string& path, FlightDump& out);
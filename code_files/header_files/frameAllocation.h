@@ -0,0 +1,125 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "nfu.h"
+
+using namespace std;
+
+// How the frames are divided among the processes of a trace (its proc field)
+enum class AllocPolicy {
+    Global, // one pool, NFU picks the victim among all pages
+    Fixed, // the same quota for every process, replacement within the process
+    PFF, // page fault frequency: each quota follows its process's fault rate
+    WSClock, // pages leave once outside their working set, found by a clock hand
+};
+
+struct AllocConfig {
+    AllocPolicy policy = AllocPolicy::Global;
+    int quota = 0; // Fixed: frames per process
+    uint64_t low = 0; // PFF: a fault less than low accesses after the previous one grows the quota
+    uint64_t high = 0; // PFF: a fault more than high accesses after the previous one shrinks it
+    uint64_t tau = 0; // WSClock: working set window, in accesses
+};
+
+// Parses "fixed:Q", "pff:LOW:HIGH" (LOW <= HIGH) or "wsclock:TAU".
+// Returns false if malformed.
+bool parseAllocSpec(const string& spec, AllocConfig& config);
+
+// Name of the policy as given on the command line
+const char* allocPolicyName(AllocPolicy policy);
+
+// Frame use of one process
+struct ProcessFrames {
+    bool seen = false; // the process has made an access
+    uint64_t accesses = 0; // accesses it made
+    uint64_t faults = 0; // its demand faults
+    uint64_t lastFault = 0; // its access count at its previous fault
+    int quota = 0; // frames it may hold (WSClock: the frames it holds)
+    int resident = 0; // frames it holds
+    int peakResident = 0; // most frames it held at once
+};
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Variable frame allocation among processes, on top of the NFU page list.
+
+  - Fixed: every process may hold quota frames. A process under its quota
+    takes a free frame, or else a frame from the process furthest over its
+    quota; at its quota it replaces its own NFU victim.
+  - PFF: as Fixed, but quotas start at 1 and move on every demand fault of
+    their process: a fault less than LOW of its own accesses after its
+    previous fault adds a frame (while the quotas still fit in the frames),
+    one more than HIGH accesses after it gives one back. Frames follow the
+    quotas lazily, when a process under its quota faults.
+  - WSClock: free frames go to whoever faults. Without one, a clock hand
+    sweeps the loaded pages: a page not used in the last TAU accesses is
+    out of its process's working set and is evicted; a dirty one is
+    cleaned (written back) and passed over, as its write-back would still
+    be in flight. After a full turn the first cleaned page goes, or the
+    page under the hand if every page is in a working set. A process's
+    quota is simply the frames it ends up with.
+
+  Per access the bookkeeping is a counter per process. Per fault, Fixed
+  and PFF scan the (at most 256) processes for a donor and then run the
+  NFU scan over the loaded pages for the victim; WSClock's hand sweeps
+  at most one full turn of the loaded pages and nothing more.
+
+  Ages are measured in global virtual time (NFU's currentTime) rather than
+  per process time.
+───────────────────────────────────────────────────────────────────────────────*/
+struct FrameAllocator {
+    static const int MAX_PROCS = 256; // the proc field is one byte
+
+    AllocConfig config;
+    vector<ProcessFrames> procs; // indexed by proc
+    int totalFrames = 0; // frames shared by all processes
+    int totalQuota = 0; // sum of the quotas (Fixed, PFF)
+    uint64_t quotaChanges = 0; // times a quota moved after its first setting
+    size_t hand = 0; // WSClock: next page the clock hand looks at
+    FILE* log = nullptr; // --quota-file CSV, null when off
+
+    FrameAllocator() = default;
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+    ~FrameAllocator() { closeLog(); }
+
+    bool enabled() const { return config.policy != AllocPolicy::Global; }
+    void init(const AllocConfig& config_, int totalFrames_);
+
+    // Opens the quota CSV and writes its header. Returns false if it can't.
+    bool openLog(const string& path);
+    void closeLog();
+
+    // count accesses by proc at virtual time now
+    void onAccess(uint8_t proc, uint64_t count, uint64_t now) {
+        ProcessFrames& p = procs[proc];
+        if (!p.seen) firstAccess(proc, now);
+        p.accesses += count;
+    }
+
+    // a demand fault of proc: PFF moves its quota
+    void onFault(uint8_t proc, uint64_t now);
+
+    // Frame for a page proc is loading: -1 to take a free frame, else the
+    // index in nfu.pages of the page to evict. WSClock appends the VPNs of
+    // the dirty pages it cleaned on the way to cleaned.
+    int pickVictim(NFUState& nfu, uint8_t proc, vector<uint64_t>& cleaned);
+
+    // a frame went from process from (-1: the free pool) to process to
+    void moveFrame(int from, uint8_t to, uint64_t now);
+
+    // rebuilds residency and quotas from the loaded pages (after a restore)
+    void resync(const NFUState& nfu);
+
+private:
+    void firstAccess(uint8_t proc, uint64_t now);
+    void setQuota(uint8_t proc, int quota, uint64_t now);
+    int wsclockVictim(NFUState& nfu, vector<uint64_t>& cleaned);
+};
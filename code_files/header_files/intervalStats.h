@@ -0,0 +1,68 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+#include "pageTable.h"
+#include "simulation.h"
+
+using namespace std;
+
+/*───────────────────────────────────────────────────────────────────────────────
+  --interval-stats N: one CSV row per window of N accesses with the window's
+  hit rate, faults and replacements, the page table size at its end, and its
+  working set (distinct pages touched). Windows are aligned to multiples of N
+  from the start of the trace, so a restored run continues the same series.
+───────────────────────────────────────────────────────────────────────────────*/
+struct IntervalRecorder {
+    int64_t every = 0; // window length in accesses, 0 when disabled
+    FILE* out = nullptr; // CSV destination
+    SimCounters windowStart; // counters when the current window began
+    int64_t window = 0; // index of the current window
+    unordered_map<uint64_t, int64_t> lastWindow; // VPN -> last window it was touched in
+    uint64_t workingSet = 0; // distinct pages touched in the current window
+    uint64_t lastVpn = 0; // page of the previous access, which needs no lookup
+    bool haveLast = false;
+
+    // Opens opts.intervalFile (stdout if empty) and writes the header; sim
+    // holds the counters the run starts from. Returns false if it can't open.
+    bool open(const RunOptions& opts, const SimCounters& sim);
+
+    // Counts an access to vpn toward the working set of the current window
+    void touch(uint64_t vpn) {
+        if (every == 0 || (haveLast && vpn == lastVpn)) return;
+        lastVpn = vpn;
+        haveLast = true;
+        auto it = lastWindow.find(vpn);
+        if (it == lastWindow.end()) {
+            lastWindow.emplace(vpn, window);
+            workingSet++;
+        } else if (it->second != window) {
+            it->second = window;
+            workingSet++;
+        }
+    }
+
+    // Accesses left in the current window (INT64_MAX when disabled)
+    int64_t untilBoundary(const SimCounters& sim) const {
+        return every == 0 ? INT64_MAX : every - sim.count % every;
+    }
+
+    // Called after every access: writes the row once the window is complete
+    void afterAccess(const PageTable& pt, const SimCounters& sim) {
+        if (every != 0 && sim.count % every == 0 && sim.count > windowStart.count) {
+            emit(pt, sim);
+        }
+    }
+
+    // Writes the trailing partial window, if any, and closes the output
+    void close(const PageTable& pt, const SimCounters& sim);
+
+private:
+    void emit(const PageTable& pt, const SimCounters& sim);
+};
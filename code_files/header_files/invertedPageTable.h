@@ -0,0 +1,62 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "map.h"
+#include "tableStats.h"
+
+using namespace std;
+
+// Inverted page table: one entry per physical frame, found through an
+// open-addressing (linear probing) hash keyed on VPN. Memory is O(frames)
+// no matter how sparse the virtual address space is.
+struct InvertedPageTable {
+    vector<Map> frames; // frame table indexed by PFN
+    vector<uint64_t> frameVpn; // VPN currently held by each frame
+    vector<int> buckets; // hash buckets holding a PFN, -1 indicates empty
+    unsigned bucketBits = 0; // log2 of the number of buckets
+    unsigned maxBucketBits = 0; // bucket array never grows past this size
+    unsigned offsetBits = 0; // Number of offset bits, used to turn addresses into VPNs
+    size_t used = 0; // Number of occupied buckets
+    TableStats* stats = nullptr; // Size counters of the owning PageTable (may be null)
+
+    // Sizes the table for the given number of frames
+    void init(int maxFrames, unsigned offsetBits_);
+
+    // Paging operations, same contract as the radix PageTable
+    Map* searchMappedPfn(uint64_t virtualAddress);
+    Map* insertMapForVpn2Pfn(uint64_t virtualAddress, int frame);
+    void removeMapForVpn2Pfn(uint64_t virtualAddress);
+
+    // reports size changes since the last call to stats
+    void syncStats();
+
+    // Returns the number of frame table entries plus hash buckets
+    uint64_t countEntries() const { return frames.size() + buckets.size(); }
+    // Returns the bytes held by the frame table and hash buckets
+    uint64_t countBytes() const {
+        return frames.size() * (sizeof(Map) + sizeof(uint64_t)) + buckets.size() * sizeof(int);
+    }
+
+private:
+    // returns the bucket a VPN hashes to
+    size_t homeBucket(uint64_t vpn) const {
+        // Fibonacci hashing, top bucketBits bits of the product
+        return (size_t)((vpn * 0x9E3779B97F4A7C15ull) >> (64 - bucketBits));
+    }
+
+    // returns the bucket holding vpn, or -1 if it is not in the table
+    long findBucket(uint64_t vpn) const;
+    // removes the given bucket, shifting later entries of the probe run back
+    void eraseBucket(size_t slot);
+    // doubles the bucket array and rehashes all frames
+    void grow();
+
+    uint64_t statsEntries = 0; // entries already reported to stats
+    uint64_t statsBytes = 0; // bytes already reported to stats
+};
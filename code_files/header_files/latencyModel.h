@@ -0,0 +1,116 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Costs of the latency model, in nanoseconds
+struct LatencyConfig {
+    uint64_t tlbHit = 1; // translation lookup paid by every access
+    uint64_t walkLevel = 100; // one page table level read on a walk
+    uint64_t memory = 100; // the data access itself
+    uint64_t minorFault = 1000; // fault served from a free frame (no I/O)
+    uint64_t majorFault = 5000; // fault handling overhead on top of the backing store read
+    uint64_t ioService = 100000; // one backing store read or write
+    unsigned queueDepth = 1; // backing store requests in service at once
+};
+
+// Applies a --latency spec to config: comma separated key=value settings
+// among tlb, walk, mem, minor, major, io and qd, e.g. "walk=80,io=50000,qd=4".
+// Keys left out keep config's value. Returns false if malformed.
+bool parseLatencySpec(const string& spec, LatencyConfig& config);
+
+/*───────────────────────────────────────────────────────────────────────────────
+  HDR-style histogram of latencies: every power of two range is split into
+  2^(SUB_BITS - 1) linear sub-buckets, so any recorded value is reported
+  within 1 / 2^(SUB_BITS - 1) of itself (< 1%) while the bucket count stays
+  small and fixed for the whole uint64_t range.
+───────────────────────────────────────────────────────────────────────────────*/
+struct LatencyHistogram {
+    static const int SUB_BITS = 8; // significant bits kept per value
+
+    vector<uint64_t> counts;
+    uint64_t total = 0; // values recorded
+
+    LatencyHistogram();
+    void record(uint64_t value);
+
+    // Smallest bucket upper bound with at least fraction q of the values at
+    // or below it (0 when empty)
+    uint64_t percentile(double q) const;
+
+private:
+    static size_t bucketOf(uint64_t value);
+    static uint64_t highestIn(size_t bucket); // largest value falling in bucket
+};
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Memory access time of a run, accumulated access by access:
+
+  - every access:      tlbHit + memory
+  - not the same page as the previous access (no translation reuse):
+                       + (walkLevels - skipped) * walkLevel, skipped being
+                         the levels a page walk cache hit saved
+  - minor fault:       + minorFault
+  - major fault:       + majorFault + wait for the backing store read
+
+  A major fault evicts a page, so it queues a write-back of the victim if
+  the victim is dirty, then a read of the new page. The backing store
+  serves queueDepth requests at a time; a request starts at the simulated
+  time it is issued or when a slot frees up, whichever is later. The
+  write-back is asynchronous, the read is waited on. Simulated time is the
+  sum of all access latencies.
+  Prefetch reads (and their write-backs) and pages cleaned ahead of their
+  eviction only occupy the backing store.
+
+  Fault latencies (minor and major) go into a histogram for percentiles.
+───────────────────────────────────────────────────────────────────────────────*/
+struct LatencyModel {
+    LatencyConfig config;
+    bool enabled = false;
+    unsigned walkLevels = 0; // page table levels read per walk
+    uint64_t now = 0; // simulated time = total memory access time so far
+    uint64_t faultTime = 0; // part of now spent serving faults
+    LatencyHistogram faults; // latency of every fault
+    vector<uint64_t> slotFree; // per backing store slot, when it finishes its request
+
+    // walkLevels_ is the number of table reads one walk costs
+    void init(const LatencyConfig& config_, unsigned walkLevels_);
+
+    // count accesses served by the previous access's translation
+    void translationReuse(uint64_t count) {
+        if (enabled) now += count * (config.tlbHit + config.memory);
+    }
+
+    // one access that walked the table (skipping skipped levels) and found its page
+    void walkHit(unsigned skipped) {
+        if (enabled) now += config.tlbHit + config.memory + (walkLevels - skipped) * config.walkLevel;
+    }
+
+    void minorFault(unsigned skipped);
+
+    // evicting a page: write-back of the victim (if writeBack), then read of the new page
+    void majorFault(unsigned skipped, bool writeBack);
+
+    // a prefetched page read in the background (after writing back the page it evicted)
+    void prefetchRead(bool writeBack) {
+        if (!enabled) return;
+        if (writeBack) issueIO();
+        issueIO();
+    }
+
+    // a dirty page cleaned ahead of its eviction, written in the background
+    void backgroundWrite() {
+        if (enabled) issueIO();
+    }
+
+private:
+    uint64_t issueIO(); // queues one backing store request at now, returns its completion time
+};
@@ -5,20 +5,56 @@
  * **/
 
 #pragma once
+#include <cstdint>
 #include "map.h"
+#include "tableStats.h"
 
 using namespace std;
 
+/*───────────────────────────────────────────────────────────────────────────────
+  Occupancy index of a sparse interior level (HAMT style). Bit i of the
+  bitmap is set when child i exists, and the present children are packed
+  in index order, so child i sits at slot
+      rank[i / 64] + popcount(bitmap[i / 64] & bits below i)
+  where rank[w] counts the children in the bitmap words before w.
+
+  Allocated as one block: this header, the bitmap words, then the ranks.
+───────────────────────────────────────────────────────────────────────────────*/
+struct SparseIndex {
+    unsigned capacity; // child slots allocated in the packed array
+    unsigned words; // bitmap words, entryCount / 64 rounded up
+
+    uint64_t* bitmap() { return reinterpret_cast<uint64_t*>(this + 1); }
+    const uint64_t* bitmap() const { return reinterpret_cast<const uint64_t*>(this + 1); }
+    uint32_t* rank() { return reinterpret_cast<uint32_t*>(bitmap() + words); }
+    const uint32_t* rank() const { return reinterpret_cast<const uint32_t*>(bitmap() + words); }
+
+    // packed slot of the child at index, which must be present
+    unsigned slotOf(unsigned index) const {
+        const uint64_t below = bitmap()[index >> 6] & ((1ull << (index & 63)) - 1);
+        return rank()[index >> 6] + (unsigned)__builtin_popcountll(below);
+    }
+
+    static uint64_t blockBytes(unsigned words) { return sizeof(SparseIndex) + words * (sizeof(uint64_t) + sizeof(uint32_t)); }
+};
+
 struct Level {
     unsigned entryCount = 0; // Number of entries possible at this level
     bool isLeaf = false; // Is this level a leaf level
-    Level **children; // Child levels
+    uint8_t sparseFill = 0; // Percent of entryCount at which a sparse interior level turns dense, 0 = always dense
+    Level **children; // Child levels: entryCount slots, or only the present ones (packed) while sparse
     Map *mappings; // Mappings at this level (only for leaf levels)
     unsigned depth; // Depth of this level in the page table
+    unsigned liveCount = 0; // Valid mappings (leaf) or allocated children (interior) currently held
+    TableStats* stats; // Size counters shared by every level of the table (may be null)
+    SparseIndex* sparse = nullptr; // Occupancy index while the children are packed, null when dense
 
     // Constructor
-    Level(unsigned entryCount_, bool isLeaf_, unsigned depth_ = 0)
-        : entryCount(entryCount_), isLeaf(isLeaf_), children(nullptr), mappings(nullptr), depth(depth_) {}
+    Level(unsigned entryCount_, bool isLeaf_, unsigned depth_ = 0, TableStats* stats_ = nullptr, uint8_t sparseFill_ = 0)
+        : entryCount(entryCount_), isLeaf(isLeaf_), sparseFill(sparseFill_), children(nullptr), mappings(nullptr),
+          depth(depth_), stats(stats_) {
+        if (stats) stats->nodeCreated(depth, sizeof(Level));
+    }
     
     // Destructor
     ~Level();
@@ -26,7 +62,8 @@ struct Level {
     Level(const Level&) = delete; // Disable copy constructor
     Level& operator=(const Level&) = delete; // Disable copy assignment
 
-    // Allocate the interior child pointer array (non lead levels)
+    // Allocate the interior child pointer array (non lead levels), or the
+    // empty sparse index when sparseFill is set
     void allocateChildren();
 
     // Allocate the leaf mappings array (leaf levels)
@@ -35,9 +72,45 @@ struct Level {
     // ensures a child exists at the given index, allocating if necessary
     Level* ensureChild(unsigned index, unsigned childEntryCount, bool childIsLeadf);
 
+    // frees the child at the given index and its whole subtree
+    void releaseChild(unsigned index);
+
+    // frees the children/mappings array once nothing live is left in it
+    void releaseStorage();
+
+    // true once the interior child storage (dense or sparse) exists
+    bool hasChildren() const { return children || sparse; }
+
+    // calls f(index, child) for every present child, in index order
+    template <typename F>
+    void forEachChild(F f) const {
+        if (sparse) {
+            unsigned slot = 0;
+            for (unsigned w = 0; w < sparse->words; w++) {
+                for (uint64_t word = sparse->bitmap()[w]; word; word &= word - 1) {
+                    f(w * 64 + (unsigned)__builtin_ctzll(word), children[slot++]);
+                }
+            }
+        } else if (children) {
+            for (unsigned i = 0; i < entryCount; i++) {
+                if (children[i]) f(i, children[i]);
+            }
+        }
+    }
+
     // Accessors
-    inline Level* getChild(unsigned index) const { return children ? children[index] : nullptr; }
+    inline Level* getChild(unsigned index) const {
+        if (sparse) {
+            if (!(sparse->bitmap()[index >> 6] & (1ull << (index & 63)))) return nullptr;
+            return children[sparse->slotOf(index)];
+        }
+        return children ? children[index] : nullptr;
+    }
     inline Map* getMapping(unsigned index) {return mappings ? &mappings[index] : nullptr; } // modifiable reference is returned
     inline const Map& getMap(unsigned index) const {return mappings[index];} // constant reference is returned
 
+private:
+    void insertSparseChild(unsigned index, Level* child); // packs child in at index
+    void makeDense(); // moves the packed children into a full entryCount array
+    void freeSparse(); // frees the sparse index and packed array (stats included)
 };
\ No newline at end of file
@@ -0,0 +1,79 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "pageTable.h"
+
+using namespace std;
+
+// Settings for -l locality
+struct LocalityOptions {
+    uint64_t tau = 10000; // working set window W(t, tau), also the sampling period of t
+    size_t topK = 10; // hot pages reported
+};
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Fenwick (binary indexed) tree over access timestamps. Slot s holds 1 while
+  the access at timestamp s is the latest access to its page, so a range sum
+  counts distinct pages touched in that range of time.
+
+  Timestamps are compacted when the tree fills up, so its size follows the
+  number of distinct pages rather than the length of the trace.
+───────────────────────────────────────────────────────────────────────────────*/
+struct TimestampTree {
+    vector<int64_t> tree; // 1-based Fenwick array
+    vector<uint64_t> accessAt; // access number of each slot, increasing
+    size_t used = 0; // slots handed out so far
+
+    void init(size_t capacity);
+    void add(size_t slot, int64_t delta);
+    int64_t prefix(size_t slot) const; // sum of slots 1..slot
+    size_t firstSlotAfter(uint64_t access) const; // first slot whose access number is > access
+};
+
+// Count-min sketch of page access counts: fixed memory, never underestimates
+struct CountMinSketch {
+    static const int DEPTH = 4; // independent hash rows
+    size_t width = 0; // counters per row
+    vector<uint64_t> counters; // DEPTH * width
+
+    void init(size_t width_);
+    uint64_t add(uint64_t key); // counts one occurrence, returns the new estimate
+};
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Single-pass locality analysis of a page reference stream:
+
+  - reuse (stack) distance histogram in power-of-two buckets,
+  - working set size W(t, tau) every tau accesses,
+  - top-K hottest pages, estimated from the count-min sketch.
+───────────────────────────────────────────────────────────────────────────────*/
+struct LocalityAnalyzer {
+    LocalityOptions opts;
+    uint64_t accesses = 0; // references seen
+    uint64_t coldAccesses = 0; // first references to a page (infinite reuse distance)
+    vector<uint64_t> reuseBuckets; // bucket b: distance 0 for b == 0, else [2^(b-1), 2^b - 1]
+    unordered_map<uint64_t, size_t> lastSlot; // VPN -> slot of its latest access
+    TimestampTree times;
+    CountMinSketch sketch;
+    vector<pair<uint64_t, uint64_t>> hot; // (VPN, estimate) candidates, at most topK
+    vector<pair<uint64_t, uint64_t>> workingSet; // (t, W(t, tau)) samples
+
+    void init(const LocalityOptions& opts_);
+    void access(uint64_t vpn);
+    void finish(); // samples W at the last access if the period left one out
+
+private:
+    void compact();
+    void trackHot(uint64_t vpn, uint64_t estimate);
+};
+
+// Prints the reuse distance, working set and hot page tables as CSV, blank line separated
+void printLocalityCsv(const LocalityAnalyzer& analyzer, const PageTable& pt);
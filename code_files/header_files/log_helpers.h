@@ -8,7 +8,7 @@
  *    in the 1999 C standard.
  *
  * C++ compilers
- *    uses uint32_t, unsigned 32 bit integer type, introduced in C++11,
+ *    uses uint32_t/uint64_t, unsigned 32/64 bit integer types, introduced in C++11,
  *    The defaults in the g++ compiler on edoras should be fine with this
  */
 
@@ -18,11 +18,13 @@
  */
 #ifdef __cplusplus
 /* C++ includes */
+#include <stddef.h>
 #include <stdint.h>
 #else
 /* C includes */
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stddef.h>
 #endif 
 
 /*
@@ -41,11 +43,15 @@ typedef struct {
   bool summary; /* summary statistics */
 } LogOptionsType;
 
+/* Longest line any log_ / format_ helper produces: 60 one-bit levels of
+ * vpns_pfn ("1 " each) or a 64-bit replacement line fit comfortably */
+#define LOG_LINE_MAX 256
+
 /**
  * @brief Print out a number in hex, one per line
  * @param number 
  */
-void print_num_inHex(uint32_t number);
+void print_num_inHex(uint64_t number);
 
 /**
  * @brief Print out bitmasks for all page table levels.
@@ -53,7 +59,7 @@ void print_num_inHex(uint32_t number);
  * @param levels - Number of levels
  * @param masks - Pointer to array of bitmasks
  */
-void log_bitmasks(int levels, uint32_t *masks);
+void log_bitmasks(int levels, const uint64_t *masks);
 
 /**
  * @brief Given a pair of numbers, output a line: 
@@ -75,11 +81,23 @@ void log_bitmasks(int levels, uint32_t *masks);
  * @param pagereplace
  * @param pthit 
  */
-void log_mapping(uint32_t src, uint32_t dest, 
-                 int vpnreplaced,
+void log_mapping(uint64_t src, uint64_t dest, 
+                 int64_t vpnreplaced,
                  unsigned int victim_bitstring,
                  bool pthit);
 
+/**
+ * @brief format the log_mapping line into buf (same text, no output).
+ * Used by callers that batch their own output.
+ * 
+ * @return number of characters written, as snprintf
+ */
+int format_mapping(char *buf, size_t len,
+                   uint64_t src, uint64_t dest, 
+                   int64_t vpnreplaced,
+                   unsigned int victim_bitstring,
+                   bool pthit);
+
 /**
  * @brief log a virtual address to physical address mapping 
  * Example usages:
@@ -87,7 +105,14 @@ void log_mapping(uint32_t src, uint32_t dest,
  * @param va 
  * @param pa 
  */
-void log_va2pa(uint32_t va, uint32_t pa);
+void log_va2pa(uint64_t va, uint64_t pa);
+
+/**
+ * @brief format the log_va2pa line into buf (same text, no output)
+ * 
+ * @return number of characters written, as snprintf
+ */
+int format_va2pa(char *buf, size_t len, uint64_t va, uint64_t pa);
 
 /**
  * @brief log vpns at all levels and the mapped physical frame number
@@ -99,6 +124,13 @@ void log_va2pa(uint32_t va, uint32_t pa);
  */
 void log_vpns_pfn(int levels, uint32_t *vpns, uint32_t frame);
 
+/**
+ * @brief format the log_vpns_pfn line into buf (same text, no output)
+ * 
+ * @return number of characters written, as snprintf
+ */
+int format_vpns_pfn(char *buf, size_t len, int levels, uint32_t *vpns, uint32_t frame);
+
 /**
  * @brief log summary information for the page table.
  * 
@@ -109,12 +141,140 @@ void log_vpns_pfn(int levels, uint32_t *vpns, uint32_t frame);
  * @param numOfFramesAllocated - Number of frames allocated
  * @param pgtableEntries - Total number of page table entries across all levels.
  */
-void log_summary(unsigned int page_size, 
-                 unsigned int numOfPageReplaces,
-                 unsigned int pageTableHits, 
-                 unsigned int numOfAddresses, 
-                 unsigned int numOfFramesAllocated,
-                 unsigned long int pgtableEntries);
+void log_summary(uint64_t page_size, 
+                 uint64_t numOfPageReplaces,
+                 uint64_t pageTableHits, 
+                 uint64_t numOfAddresses, 
+                 uint64_t numOfFramesAllocated,
+                 uint64_t pgtableEntries);
+
+/**
+ * @brief log page table memory usage, printed after log_summary.
+ * 
+ * @param pgtableBytes - Bytes currently held by the page table
+ * @param peakBytes - Largest number of bytes held at any point of the run
+ * @param peakEntries - Largest number of page table entries at any point of the run
+ */
+void log_pagetable_usage(uint64_t pgtableBytes,
+                         uint64_t peakBytes,
+                         uint64_t peakEntries);
+
+/**
+ * @brief log dirty page write-backs, printed after log_pagetable_usage.
+ * 
+ * @param writeBacks - Evicted pages that were dirty and written back
+ * @param pageSize - Bytes per page
+ * @param replacements - Page replacements (evictions by demand faults)
+ */
+void log_write_backs(uint64_t writeBacks,
+                     uint64_t pageSize,
+                     uint64_t replacements);
+
+/**
+ * @brief log hit / miss counts of one data cache level, printed after
+ * log_pagetable_usage.
+ * 
+ * @param level - Cache level, 1 for L1
+ * @param hits - Accesses that found their line in this level
+ * @param misses - Accesses that went on to the next level (or memory)
+ */
+void log_cache_level(int level,
+                     uint64_t hits,
+                     uint64_t misses);
+
+/**
+ * @brief log page walk cache use, printed after log_pagetable_usage.
+ * 
+ * @param walks - Demand table walks (one per access that searched the table) done with the cache on
+ * @param resumedAt - resumedAt[d]: walks that started from a cached level at depth d
+ * @param depths - Number of entries in resumedAt (the page table's level count)
+ */
+void log_walk_cache(uint64_t walks,
+                    const uint64_t *resumedAt,
+                    int depths);
+
+/**
+ * @brief log prefetch effectiveness, printed after log_pagetable_usage.
+ * 
+ * Accuracy is used / issued; coverage is the share of would-be misses that
+ * prefetching turned into hits, used / (used + misses).
+ * 
+ * @param issued - Pages prefetched
+ * @param used - Prefetched pages referenced before their eviction
+ * @param polluted - Prefetched pages evicted without ever being referenced
+ * @param misses - Demand misses left
+ */
+void log_prefetch(uint64_t issued,
+                  uint64_t used,
+                  uint64_t polluted,
+                  uint64_t misses);
+
+/**
+ * @brief log the per-process frame allocation policy, printed after
+ * log_pagetable_usage and followed by one log_process_frames line per process.
+ * 
+ * @param policy - Policy name (fixed, pff, wsclock)
+ * @param quotaChanges - Times a quota moved after its first setting
+ */
+void log_frame_allocation(const char *policy,
+                          uint64_t quotaChanges);
+
+/**
+ * @brief log the frame use of one process.
+ * 
+ * @param proc - Process number (trace proc field)
+ * @param accesses - Accesses the process made
+ * @param faults - Its demand faults
+ * @param quota - Frames it may hold at the end of the run
+ * @param resident - Frames it holds at the end of the run
+ * @param peakResident - Most frames it held at once
+ */
+void log_process_frames(int proc,
+                        uint64_t accesses,
+                        uint64_t faults,
+                        int quota,
+                        int resident,
+                        int peakResident);
 
+/**
+ * @brief log the latency model's totals, printed after log_pagetable_usage.
+ * 
+ * @param totalTime - Memory access time of the whole run, in ns
+ * @param numOfAddresses - Number of addresses processed
+ * @param faults - Number of faults (minor and major)
+ * @param faultTime - Part of totalTime spent serving faults, in ns
+ * @param p50 - Median fault latency, in ns
+ * @param p99 - 99th percentile fault latency, in ns
+ * @param p999 - 99.9th percentile fault latency, in ns
+ */
+void log_latency_summary(uint64_t totalTime,
+                         uint64_t numOfAddresses,
+                         uint64_t faults,
+                         uint64_t faultTime,
+                         uint64_t p50,
+                         uint64_t p99,
+                         uint64_t p999);
+
+/**
+ * @brief log extrapolated statistics of a sampled run.
+ * 
+ * Percentages are per-window means; the +/- values are 95% confidence
+ * half widths. Estimated counts scale the percentages to totalAccesses.
+ * 
+ * @param page_size - Number of bytes per page
+ * @param windows - Number of measured windows
+ * @param measuredAccesses - Accesses inside measured windows
+ * @param totalAccesses - Accesses the estimate is extrapolated to
+ * @param hitPercent - Mean page hit percentage
+ * @param hitHalfWidth - Confidence half width of hitPercent
+ * @param replacePercent - Mean page replacement percentage
+ * @param replaceHalfWidth - Confidence half width of replacePercent
+ */
+void log_sampled_summary(uint64_t page_size,
+                         uint64_t windows,
+                         uint64_t measuredAccesses,
+                         uint64_t totalAccesses,
+                         double hitPercent, double hitHalfWidth,
+                         double replacePercent, double replaceHalfWidth);
 
 #endif
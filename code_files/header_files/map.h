@@ -11,4 +11,5 @@ using namespace std;
 struct Map {
     int pfn = -1; // Physical Frame Number -1, indicates unmapped
     bool valid = false; // Valid bit
+    bool dirty = false; // Dirty bit, set when the page is written while mapped
 };
\ No newline at end of file
@@ -14,34 +14,46 @@ using namespace std;
 
 struct LoadedPage {
     int pfn; // Physical Frame Number
-    uint32_t vpn; // Virtual Page Number
+    uint64_t vpn; // Virtual Page Number
     uint16_t bitstring; // 16-bit aging bitstring
-    uint32_t lastAccessTime; // last access time for tie-breaking
+    uint64_t lastAccessTime; // last access time for tie-breaking
+    bool dirty; // written since it was loaded (mirrors the PTE's dirty bit for victim selection)
+    uint8_t proc; // process that loaded it (trace proc field)
 };
 
 struct NFUState {
     vector<LoadedPage> pages; // all currently  loaded pages
-    unordered_map<uint32_t, size_t> vpnToIndex; // maps VPN to index in pages vector for quick lookup
-    unordered_set<uint32_t> accessed; // all VPNs accessed in this interval will have their bitstring's MSB set to 1
-    uint32_t currentTime; // current time for tie-breaking
-    uint32_t timeSinceTick; // time since last bitstring update
+    unordered_map<uint64_t, size_t> vpnToIndex; // maps VPN to index in pages vector for quick lookup
+    unordered_set<uint64_t> accessed; // all VPNs accessed in this interval will have their bitstring's MSB set to 1
+    uint64_t currentTime; // current time for tie-breaking
+    uint64_t timeSinceTick; // time since last bitstring update
     int maxFrames = 0; // maximum number of physical frames allocated before beginning page replacement
-    int interval = 0; // interval for updating bitstrings
+    uint64_t interval = 0; // interval for updating bitstrings
+    uint64_t ticks = 0; // intervals completed so far (not checkpointed, only compared within a run)
+    int cleanTolerance = -1; // >= 0: prefer clean victims within this bitstring distance of the NFU minimum
 };
 
-extern NFUState nfuState; // makes a global NFUState object accessible across multiple files
-
+// Every function below works on the NFUState it is given; each simulator owns its own
 // Initializes the NFU state with the given number of frames and update interval
-void initNFUState(int numFrames, int updateInterval);
+void initNFUState(NFUState& nfuState, int numFrames, int updateInterval);
 // Called at beginning of each memory access to update virtual time and shift bitstring if interval reached
-void beforeAccessNFU();
-// updates page's last access time and marks it as accessed when a page is already loaded
-void onHitNFU(uint32_t vpn);
-// adds new page and initializes its bitstring when a page is not loaded
-void onMissNFU(uint32_t vpn, int pfn);
+void beforeAccessNFU(NFUState& nfuState);
+// updates page's last access time and marks it as accessed when a page is already loaded,
+// returns the page's index in pages
+size_t onHitNFU(NFUState& nfuState, uint64_t vpn);
+// same as count back-to-back beforeAccessNFU + onHitNFU calls for the page at index, without the
+// VPN lookup; markedTick is the tick the page was last added to accessed in (kept by the caller)
+void onRepeatHitsNFU(NFUState& nfuState, size_t index, uint64_t count, uint64_t& markedTick);
+// adds new page and initializes its bitstring when a page is not loaded; a prefetched page
+// starts from initialBits without being marked as referenced
+void onMissNFU(NFUState& nfuState, uint64_t vpn, int pfn, uint16_t initialBits = 0x8000, bool referenced = true);
 // returns true if all frames are currently used
-bool isFullNFU();
-// selects victim page to evict based on bitstring, and in case of tie, last access time
-int selectVictimNFU();
-// reuses the victim page's frame for new VPN, returns old vpn and bitstring for logging
-pair<uint32_t, uint16_t> reuseSlotNFU(int victimIndex, uint32_t newVPN);
\ No newline at end of file
+bool isFullNFU(const NFUState& nfuState);
+// selects victim page to evict based on bitstring, and in case of tie, last access time;
+// with cleanTolerance >= 0 a clean page close enough to the minimum bitstring goes first;
+// proc >= 0 limits the choice to the pages of that process
+int selectVictimNFU(const NFUState& nfuState, int proc = -1);
+// reuses the victim page's frame for new VPN (clean), returns old vpn and bitstring for logging
+// (initialBits / referenced as in onMissNFU); the caller reads the victim's dirty flag first
+pair<uint64_t, uint16_t> reuseSlotNFU(NFUState& nfuState, int victimIndex, uint64_t newVPN,
+                                      uint16_t initialBits = 0x8000, bool referenced = true);
\ No newline at end of file
@@ -6,45 +6,84 @@
 #pragma once
 #include <vector>
 #include <cstdint>
+#include "addressBatch.h"
 #include "level.h"
+#include "invertedPageTable.h"
+#include "pageWalkCache.h"
 
 using namespace std;
 
 struct PageTable {
     int numLevels = 0; // Number of levels in the page table
     vector<unsigned> entryCount; // Number of entries possible at each level. 1 << levelBits[i]
-    vector<unsigned> bitmasks; // Bitmask for each level
+    vector<uint64_t> bitmasks; // Bitmask for each level
     vector<unsigned> shifts; // Right shift amount for each level
+    unsigned addressBits = 32; // Width of a virtual address (32, or 48/57 for x86-64 traces)
     unsigned offsetBits = 0; // Number of offset bits
-    unsigned offsetMask = 0; //Bitmask for offset
+    uint64_t offsetMask = 0; //Bitmask for offset
     Level* rootLevel = nullptr; // Pointer to the root level of the page table
+    bool reclaimEmptyLevels = false; // Free leaf/interior levels once their last valid mapping is removed
+    InvertedPageTable* inverted = nullptr; // Hashed/inverted backend, used instead of the Level tree when set
+    TableStats stats; // Incrementally maintained entry/byte/node counters
+    PageWalkCache walkCache; // Cached upper levels that tree walks resume from (off unless enabled)
 
     // Destructor
     ~PageTable();
 
     // Function to build masks/shifts/entries from levelBits
-    void initFromLevelBits(const vector<int>& levelBits);
+    // addressBits_ is the virtual address width, the offset gets whatever levelBits leaves over
+    void initFromLevelBits(const vector<int>& levelBits, unsigned addressBits_ = 32);
+
+    // Switches lookups to an inverted page table sized for maxFrames frames.
+    // Must be called after initFromLevelBits (needs offsetBits)
+    void useInvertedBackend(int maxFrames);
+
+    // Makes interior levels sparse (bitmap + packed children) until fillPercent
+    // of their entries are in use, then dense. Must be called before any insert
+    void useSparseLevels(uint8_t fillPercent) { if (rootLevel) rootLevel->sparseFill = fillPercent; }
+
+    // Turns on the page walk cache with entriesPerDepth[d - 1] entries for depth d.
+    // Must be called after initFromLevelBits (needs shifts)
+    void useWalkCache(const vector<unsigned>& entriesPerDepth) { walkCache.init(entriesPerDepth, shifts, addressBits); }
 
     // returns the number of bytes of each page table entry
     // example: if offset bits is 12, each page is 1000 0000 0000 in binary, or 4096 bytes
-    unsigned pageSizeBytes() const { return (1u << offsetBits); } // u makes 1 unsigned, << is left shift
+    uint64_t pageSizeBytes() const { return (1ull << offsetBits); } // ull makes 1 unsigned 64-bit, << is left shift
 
     // returns a given individual VPN piece
     // example: if levels are 6 6 8 and level = 0, returns bits 31-26
-    unsigned getVPNPiece(uint32_t vaddr, int level) const {
+    unsigned getVPNPiece(uint64_t vaddr, int level) const {
         // & is bitwise AND, >> is right shift
-        return (vaddr & bitmasks[level]) >> shifts[level];
+        return (unsigned)((vaddr & bitmasks[level]) >> shifts[level]);
     }
 
     // gets the offset from a virtual address
-    unsigned getOffset(uint32_t vaddr) const {return vaddr & offsetMask; }
+    uint64_t getOffset(uint64_t vaddr) const {return vaddr & offsetMask; }
+
+    // getVPNPiece + getOffset for a block of addresses: writes pieces[level][i] and
+    // offsets[i] for i < n. Uses AVX2 when the CPU has it, scalar code otherwise
+    void decomposeBatch(const uint64_t* vaddrs, size_t n, uint32_t* const* pieces, uint64_t* offsets) const;
 
-    // Returns the total number of page table entries currently present:
+    // decomposes batch.vaddr[0, batch.count) into the batch's own rows / offsets
+    void decomposeBatch(AddressBatch& batch) const {
+        decomposeBatch(batch.vaddr.data(), batch.count, batch.rows.data(), batch.offset.data());
+    }
+
+    // Returns the total number of page table entries currently present, O(1)
     uint64_t countEntries(const PageTable* pt);
 
+    // Returns the bytes currently held by the page table, O(1)
+    uint64_t countBytes() const { return stats.bytes; }
+
     // Paging operations
-    Map* searchMappedPfn(unsigned int virtualAddress);
-    void  insertMapForVpn2Pfn(unsigned int virtualAddress, int frame);
-    unsigned int extractVPNFromVirtualAddress(unsigned int virtualAddress, unsigned int mask, unsigned int shift);
+    Map* searchMappedPfn(uint64_t virtualAddress);
+    Map* insertMapForVpn2Pfn(uint64_t virtualAddress, int frame);
+    // Same operations walking with access i's indices from a decomposed batch
+    Map* searchMappedPfn(uint64_t virtualAddress, const AddressBatch& batch, size_t i);
+    Map* insertMapForVpn2Pfn(uint64_t virtualAddress, const AddressBatch& batch, size_t i, int frame);
+    // searchMappedPfn that is not a demand walk (left out of the walk cache counters)
+    Map* probeMappedPfn(uint64_t virtualAddress);
+    void  removeMapForVpn2Pfn(uint64_t virtualAddress);
+    unsigned int extractVPNFromVirtualAddress(uint64_t virtualAddress, uint64_t mask, unsigned int shift);
 };
 
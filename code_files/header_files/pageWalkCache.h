@@ -0,0 +1,97 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct Level;
+
+// Parses "N[,N...]": entries cached for depth 1, 2, ... (0 leaves a depth
+// uncached). Returns false if malformed.
+bool parseWalkCacheSpec(const string& spec, vector<unsigned>& entriesPerDepth);
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Paging-structure (page walk) cache: remembers the Level reached after the
+  top d VPN pieces, for each configured depth d >= 1 (up to the leaf level,
+  which leaves just the final index to read), keyed on those pieces (the
+  address bits above the level d piece). A walk probes the deepest depth
+  first and resumes from the first hit instead of the root.
+
+  Each depth is a direct-mapped array of a power-of-two number of entries,
+  indexed by bits of a Fibonacci hash of the key. Entries point into the
+  tree, so a level freed by reclaim (-r) must be invalidated before it is
+  deleted.
+───────────────────────────────────────────────────────────────────────────────*/
+struct PageWalkCache {
+    struct Entry {
+        uint64_t key = 0; // keyOf(address, depth)
+        Level* level = nullptr; // null: empty
+    };
+
+    vector<vector<Entry>> entries; // [depth], depth 0 (the root) is never cached
+    vector<unsigned> keyShift; // [depth]: shift of the level depth - 1 piece
+    vector<uint64_t> keyMask; // [depth]: VPN bits left after keyShift (bits past the address width are ignored)
+    vector<uint64_t> indexMask; // [depth]: entries - 1
+    vector<uint64_t> resumedAt; // [depth]: walks that started from a cached level at depth
+    uint64_t walks = 0; // demand lookups (lookup() calls) done with the cache on
+    unsigned lastStartDepth = 0; // depth the latest lookup() started at, 0 from the root
+    int deepest = 0; // deepest depth with entries
+
+    // entriesPerDepth[d - 1] entries for depth d (rounded up to a power of two);
+    // shifts and addressBits are the page table's. An empty list disables the cache.
+    void init(const vector<unsigned>& entriesPerDepth, const vector<unsigned>& shifts, unsigned addressBits);
+    bool enabled() const { return deepest > 0; }
+
+    // Deepest cached level on the path of vaddr, or null (lastStartDepth tells which depth).
+    // Counts as a demand walk in walks / resumedAt.
+    Level* lookup(uint64_t vaddr) {
+        walks++;
+        Level* level = probe(vaddr, lastStartDepth);
+        if (level) resumedAt[lastStartDepth]++;
+        return level;
+    }
+
+    // Same as lookup, but leaves the counters alone (walks the simulator does
+    // for itself: inserts, prefetch residency checks, write-back cleanup)
+    Level* probe(uint64_t vaddr, unsigned& depthFound) const {
+        for (int depth = deepest; depth > 0; depth--) {
+            if (entries[depth].empty()) continue;
+            const uint64_t key = keyOf(vaddr, depth);
+            const Entry& entry = entries[depth][slotOf(depth, key)];
+            if (entry.level && entry.key == key) {
+                depthFound = (unsigned)depth;
+                return entry.level;
+            }
+        }
+        depthFound = 0;
+        return nullptr;
+    }
+
+    // Remembers level (at depth) as the node on vaddr's path
+    void fill(uint64_t vaddr, unsigned depth, Level* level) {
+        if ((int)depth > deepest || entries[depth].empty()) return;
+        const uint64_t key = keyOf(vaddr, depth);
+        Entry& entry = entries[depth][slotOf(depth, key)];
+        entry.key = key;
+        entry.level = level;
+    }
+
+    // Drops the entry for the level at depth on vaddr's path, if cached
+    void invalidate(uint64_t vaddr, unsigned depth);
+
+private:
+    uint64_t keyOf(uint64_t vaddr, int depth) const {
+        return (vaddr >> keyShift[depth]) & keyMask[depth];
+    }
+
+    size_t slotOf(int depth, uint64_t key) const {
+        return (size_t)(((key * 0x9E3779B97F4A7C15ULL) >> 32) & indexMask[depth]);
+    }
+};
@@ -0,0 +1,30 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "pageTable.h"
+#include "simulation.h"
+
+using namespace std;
+
+// Which per-access output the pipeline's formatting stage produces
+enum class PipelineOutput {
+    None, // summary: no per-access lines
+    Va2pa, // va2pa lines
+    VpnsPfn, // vpns_pfn lines
+    Vpn2pfnPr, // vpn2pfn_pr lines
+};
+
+// Runs the simulation over traceFiles (merged by time when there are several)
+// as four threads connected by SPSC rings:
+//   1. trace decode  2. VPN / offset extraction  3. page table + NFU  4. output formatting
+// Per-access output is byte-for-byte what the single-threaded modes print;
+// simulator holds the final totals for the caller's summary.
+// Returns 0 on success, 1 if the trace or checkpoint cannot be opened.
+int runPipelined(const vector<string>& traceFiles, Simulator& simulator, const RunOptions& opts, PipelineOutput output);
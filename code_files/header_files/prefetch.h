@@ -0,0 +1,95 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+// Which pages are loaded along with a faulting page
+enum class PrefetchPolicy {
+    None,
+    NextN, // the next N pages
+    Stride, // N pages along a fault stride seen twice in a row
+    Adaptive, // sequential readahead window that grows while the stream stays sequential
+};
+
+struct PrefetchConfig {
+    PrefetchPolicy policy = PrefetchPolicy::None;
+    unsigned degree = 4; // pages per prefetch (NextN, Stride) or largest window (Adaptive)
+};
+
+// Parses "next:N", "stride:N" or "adaptive:MAX" (N, MAX in 1..1024).
+// Returns false if malformed.
+bool parsePrefetchSpec(const string& spec, PrefetchConfig& config);
+
+// How well prefetching did
+struct PrefetchStats {
+    uint64_t issued = 0; // pages prefetched
+    uint64_t used = 0; // prefetched pages referenced before their eviction
+    uint64_t polluted = 0; // prefetched pages evicted without ever being referenced
+    uint64_t frames = 0; // prefetches that took a free frame
+    uint64_t evictions = 0; // prefetches that evicted a page
+};
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Picks the pages to prefetch when a page faults.
+
+  - NextN: vpn + 1 .. vpn + N.
+  - Stride: once two consecutive faults are the same distance d apart,
+    vpn + d, vpn + 2d, .. vpn + N*d.
+  - Adaptive (after Linux readahead): a fault right after the previous
+    fault or at the end of the previous window is sequential and opens a
+    window of twice the previous size (4 pages at first, up to MAX) after
+    the faulting page. The first page of each window is a marker: the
+    first reference to it reads the next window ahead of time, so a
+    sequential stream stops faulting.
+
+  Also keeps the set of prefetched pages that nobody has referenced yet.
+───────────────────────────────────────────────────────────────────────────────*/
+struct Prefetcher {
+    PrefetchConfig config;
+    PrefetchStats stats;
+    unordered_set<uint64_t> unused; // prefetched pages not referenced yet
+
+    bool enabled() const { return config.policy != PrefetchPolicy::None; }
+    void init(const PrefetchConfig& config_, uint64_t maxVpn_);
+
+    // Pages to prefetch for a fault on vpn (appended to out)
+    void onFault(uint64_t vpn, vector<uint64_t>& out);
+
+    // vpn was hit; counts a first reference to a prefetched page and appends
+    // the next window to out when it was the readahead marker
+    void onHit(uint64_t vpn, vector<uint64_t>& out) {
+        if (!unused.empty() && unused.erase(vpn)) {
+            stats.used++;
+            if (config.policy == PrefetchPolicy::Adaptive && vpn == marker) {
+                readAhead(out);
+            }
+        }
+    }
+
+    // vpn was evicted
+    void onEvict(uint64_t vpn) {
+        if (!unused.empty() && unused.erase(vpn)) stats.polluted++;
+    }
+
+private:
+    uint64_t maxVpn = 0; // largest VPN of the address space
+    bool haveFault = false;
+    uint64_t lastFault = 0; // VPN of the previous fault
+    int64_t lastStride = 0; // distance between the two previous faults
+    uint64_t windowStart = 0; // Adaptive: first page of the latest window
+    uint64_t windowSize = 0; // its size, 0 when no sequential stream is open
+    uint64_t marker = UINT64_MAX; // Adaptive: page whose first reference reads ahead
+
+    void addRun(uint64_t first, int64_t step, uint64_t count, vector<uint64_t>& out) const;
+    void openWindow(uint64_t start, uint64_t size, vector<uint64_t>& out);
+    void readAhead(vector<uint64_t>& out); // opens the next, larger window after the current one
+};
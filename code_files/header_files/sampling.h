@@ -0,0 +1,42 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Window sizes for sampled (SimPoint-style) simulation, repeated until the trace ends
+struct SampleWindows {
+    int64_t fastForward = 0; // accesses skipped (functional only, or seeked over)
+    int64_t warmup = 0; // accesses simulated to re-warm state, not measured
+    int64_t measure = 0; // accesses simulated and measured
+    bool seek = false; // seek over fast-forward records instead of simulating them
+};
+
+// Parses "FF,WARM,MEASURE" into windows, returns false if malformed
+bool parseSampleWindows(const string& spec, SampleWindows& windows);
+
+// Running mean / variance of per-window measurements (Welford's method)
+struct SampleStats {
+    uint64_t n = 0; // windows added
+    double mean = 0.0; // running mean
+    double m2 = 0.0; // sum of squared differences from the mean
+
+    void add(double x) {
+        n++;
+        const double delta = x - mean;
+        mean += delta / (double)n;
+        m2 += delta * (x - mean);
+    }
+
+    // sample standard deviation, 0 with fewer than two windows
+    double stddev() const;
+
+    // half width of the 95% confidence interval of the mean
+    double halfWidth95() const;
+};
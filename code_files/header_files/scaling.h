@@ -0,0 +1,41 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "pageTable.h"
+#include "traceSource.h"
+
+using namespace std;
+
+// Largest --threads value
+static const int MAX_SCALING_THREADS = 256;
+
+/*───────────────────────────────────────────────────────────────────────────────
+  -l scaling: how translation through one shared ConcurrentPageTable scales
+  with the number of threads.
+
+  The trace (all files, merged by time as usual, up to numAccesses records
+  that filter accepts) is read into memory once. Then, for 1, 2, 4, ...
+  threads and finally maxThreads, a fresh table is filled by that many
+  threads at once, each translating one contiguous slice of the accesses
+  (the same total work for every thread count). Each thread count is timed a few times and the
+  fastest run kept, which filters out scheduling noise.
+
+  Prints CSV: threads, seconds, accesses, million accesses per second,
+  speedup over one thread, pages this run mapped and races lost while
+  mapping (CAS failures on a leaf entry), and the mapped pages counted
+  afterwards, which must be the same for every thread count.
+
+  Only translation and demand mapping are measured: frames never run out
+  and no page is replaced, as NFU is inherently one global ordering.
+
+  Returns 0 on success, 1 if the trace cannot be opened.
+───────────────────────────────────────────────────────────────────────────────*/
+int runScaling(const vector<string>& traceFiles, const PageTable& layout, int64_t numAccesses,
+               const TraceFilter& filter, int maxThreads);
@@ -0,0 +1,180 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "cacheModel.h"
+#include "flightRecorder.h"
+#include "frameAllocation.h"
+#include "latencyModel.h"
+#include "nfu.h"
+#include "pageTable.h"
+#include "prefetch.h"
+#include "traceSource.h"
+
+using namespace std;
+
+// Page touched by the most recent access. While the next access stays on the
+// same page nothing can have evicted it, so that access skips the table walk
+// and the NFU lookup. Not checkpointed: a restored run starts without one.
+struct RunCache {
+    int64_t at = -1; // SimCounters::count right after that access, -1 if none
+    uint64_t vpn = 0; // its virtual page number
+    Map* mapping = nullptr; // its mapping
+    size_t nfuIndex = 0; // its index in NFUState::pages
+    uint64_t markedTick = UINT64_MAX; // NFUState::ticks when it was last added to NFUState::accessed
+};
+
+// Running totals of a simulation, carried from access to access
+// (and saved/restored with checkpoints)
+struct SimCounters {
+    int64_t count = 0; // accesses processed so far
+    int nextFreePFN = 0; // next never-used physical frame
+    uint64_t hits = 0; // page table hits
+    uint64_t pageReplacements = 0; // misses that evicted a victim page
+    uint64_t framesAllocated = 0; // misses served from a free frame
+    uint64_t writeBacks = 0; // dirty pages written back when evicted (prefetch evictions included)
+    RunCache run; // same-page fast path state
+};
+
+// Settings shared by all simulating log modes
+struct RunOptions {
+    int64_t numAccesses = -1; // If <= 0: process entire trace; else: stop once this many accesses are done
+    int64_t checkpointAt = -1; // Access count at which to write checkpointFile (-1: never)
+    string checkpointFile; // Where --checkpoint-at writes the snapshot
+    string restoreFile; // Checkpoint to resume from (empty: start at the beginning of the trace)
+    int64_t intervalStats = 0; // Accesses per --interval-stats window (0: off)
+    string intervalFile; // Where the window rows go (empty: stdout)
+    TraceFilter filter; // Records the trace source passes on (--proc, --reqtype, --addr-range)
+};
+
+// What happened on a single access, used by the log modes
+struct AccessOutcome {
+    Map* mapping = nullptr; // mapping of the accessed page after the access
+    bool pthit = false; // true if the page was already mapped
+    int64_t vpnReplaced = -1; // VPN of the evicted page, -1 if nothing was replaced
+    uint16_t victimBitstring = 0; // NFU bitstring of the evicted page
+    uint8_t walkSkipped = 0; // table levels the page walk cache saved on the lookup (0 on the same-page path)
+};
+
+// How a simulator is built
+struct SimulatorConfig {
+    vector<int> levelBits; // bits of each page table level, root first (1..30 each)
+    unsigned addressBits = 32; // virtual address width, 32..64; leaves at least 4 offset bits
+    int frames = 999999; // physical frames available before NFU replacement starts
+    int bitUpdateInterval = 10; // accesses per NFU aging tick
+    bool inverted = false; // inverted page table backend instead of the Level tree
+    bool reclaimLevels = false; // free levels left without valid mappings
+    int sparseFill = 0; // 1..100: interior levels stay sparse up to this percent full (0: always dense; radix only)
+    int cleanTolerance = -1; // >= 0: NFU prefers clean victims within this bitstring distance (-1: off)
+    AllocConfig alloc; // how frames are divided among processes (default: one global NFU pool)
+    vector<CacheLevelConfig> caches; // data caches behind translation, L1 first (none: no cache model)
+    vector<unsigned> walkCache; // page walk cache entries for depth 1, 2, ... (empty: none; radix only)
+    PrefetchConfig prefetch; // pages loaded along with a faulting page
+    bool latencyModel = false; // accumulate memory access time with the costs below
+    LatencyConfig latency; // costs of the latency model
+};
+
+// Totals a caller can query at any point of a run
+struct SimulatorStats {
+    uint64_t pageSize = 0; // bytes per page
+    uint64_t accesses = 0; // accesses simulated
+    uint64_t hits = 0; // page table hits
+    uint64_t misses = 0; // accesses that had to map their page
+    uint64_t pageReplacements = 0; // misses that evicted a victim page
+    uint64_t framesAllocated = 0; // misses served from a free frame
+    uint64_t writeBacks = 0; // dirty pages written back when evicted
+    uint64_t tableEntries = 0; // page table entries currently allocated
+    uint64_t tableBytes = 0; // bytes currently held by the page table
+    uint64_t peakEntries = 0; // most entries held at once
+    uint64_t peakBytes = 0; // most bytes held at once
+};
+
+/*───────────────────────────────────────────────────────────────────────────────
+  One self-contained paging simulator: page table, NFU state and counters.
+  Instances share nothing, so a process can run any number of them side by
+  side (one thread per instance). Not copyable: the page table owns its tree.
+───────────────────────────────────────────────────────────────────────────────*/
+struct Simulator {
+    PageTable pt; // translation structure
+    NFUState nfu; // replacement policy state
+    SimCounters counters; // running totals
+    CacheHierarchy caches; // fed the physical address of every access (not checkpointed)
+    LatencyModel latency; // memory access time and fault latencies (not checkpointed)
+    Prefetcher prefetcher; // fault-time prefetch policy and its stats (not checkpointed)
+    FrameAllocator allocator; // per-process frame quotas
+    FlightRecorder recorder; // ring of recent events, off unless enabled (not checkpointed)
+
+    Simulator() = default;
+    Simulator(const Simulator&) = delete;
+    Simulator& operator=(const Simulator&) = delete;
+    ~Simulator() { pt.stats.recorder = nullptr; } // the table's teardown is not worth recording
+
+    // Builds the page table and NFU state; call once, with a config the CLI would accept
+    void init(const SimulatorConfig& config);
+
+    // Translates one virtual address: page table lookup, NFU bookkeeping, and on a
+    // miss either a free frame or an NFU victim (written back first if dirty). A
+    // write sets the page's dirty bit. proc is the process making the access, which
+    // matters to per-process frame allocation. Updates counters (including count).
+    AccessOutcome access(uint64_t vaddr, bool write = false, uint8_t proc = 0);
+
+    // Same as above for access i of a decomposed batch, walking with its precomputed
+    // indices (batch.write[i] and batch.proc[i] give the rest)
+    AccessOutcome access(const AddressBatch& batch, size_t i);
+
+    // Simulates n reads by process 0 in order, decomposing them in batches first. When
+    // outcomes is not null it receives one outcome per address.
+    void accessBatch(const uint64_t* vaddrs, size_t n, AccessOutcome* outcomes = nullptr);
+
+    // Functional-only access (sampled mode's fast-forward): leaves the page table, NFU
+    // state, dirty bits and frame allocation as access() would, but feeds nothing to
+    // the caches, latency model, flight recorder, prefetcher or counters.
+    void warmAccess(uint64_t vaddr, bool write = false, uint8_t proc = 0);
+
+    // Simulates count accesses that repeat the page of the previous access in one
+    // step: NFU time, ticks and accessed state advance exactly as per-access calls would.
+    // write is true if any of them writes the page, proc makes them all. The caches
+    // see none of them, so callers modelling caches use access() instead.
+    void repeatHits(uint64_t count, bool write = false, uint8_t proc = 0);
+
+    SimulatorStats stats() const;
+
+    // Turns on the flight recorder with a ring of events (see flightRecorder.h),
+    // table allocations included; dumps go to path. Call after init.
+    void enableFlightRecorder(uint64_t events, const string& path);
+
+private:
+    AddressBatch scratch; // accessBatch's decomposition buffer
+    vector<uint64_t> prefetchQueue; // pages the prefetcher asked for during the current access
+    vector<uint64_t> cleaned; // pages the allocator wrote back while looking for a victim
+
+    int pickVictim(uint8_t proc, bool account = true); // account: count and time cleaned pages
+    void installPrefetches(uint8_t proc);
+    void repeatStep(uint64_t count, bool write, uint8_t proc); // repeatHits without the recorder
+    void recordTicks(uint64_t ticksBefore); // a Tick event if NFU aged since ticksBefore
+
+    template <typename Search, typename Insert>
+    AccessOutcome accessStep(uint64_t vaddr, bool write, uint8_t proc, Search search, Insert insert);
+};
+
+// Number of accesses from i on (up to end) that touch the same page as access i - 1,
+// from the same process
+size_t sameVpnRun(const PageTable& pt, const AddressBatch& batch, size_t i, size_t end);
+
+// Reads up to batch.capacity records (fewer if maxCount >= 0 is smaller) into
+// batch and decomposes them. Returns the number read, 0 at the end of the trace.
+size_t readAddressBatch(TraceSource& source, const PageTable& pt, AddressBatch& batch, int64_t maxCount);
+
+// Opens the trace files (merged by time when there are several) for a run.
+// When opts.restoreFile is set, restores the simulator from that checkpoint
+// and positions the stream where the checkpointed run stopped.
+// Returns false (after printing why) on failure.
+bool openTraceForRun(const vector<string>& traceFiles, Simulator& simulator, const RunOptions& opts,
+                     TraceSource& source);
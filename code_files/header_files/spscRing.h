@@ -0,0 +1,53 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+using namespace std;
+
+// Lock-free single-producer / single-consumer ring buffer.
+// Exactly one thread may push and exactly one (other) thread may pop.
+// Capacity must be a power of two.
+template <typename T, size_t Capacity>
+struct SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+    // head and tail live on separate cache lines so producer and consumer don't false-share
+    alignas(64) atomic<size_t> head{0}; // next slot to pop, written by the consumer only
+    alignas(64) atomic<size_t> tail{0}; // next slot to push, written by the producer only
+    alignas(64) T slots[Capacity];
+
+    // returns false if the ring is full
+    bool tryPush(const T& value) {
+        const size_t t = tail.load(memory_order_relaxed);
+        if (t - head.load(memory_order_acquire) == Capacity) return false;
+        slots[t & (Capacity - 1)] = value;
+        tail.store(t + 1, memory_order_release); // publishes the slot to the consumer
+        return true;
+    }
+
+    // returns false if the ring is empty
+    bool tryPop(T& value) {
+        const size_t h = head.load(memory_order_relaxed);
+        if (h == tail.load(memory_order_acquire)) return false;
+        value = slots[h & (Capacity - 1)];
+        head.store(h + 1, memory_order_release); // hands the slot back to the producer
+        return true;
+    }
+
+    // blocking versions, spin then yield while the other side catches up
+    void push(const T& value) {
+        while (!tryPush(value)) this_thread::yield();
+    }
+    T pop() {
+        T value;
+        while (!tryPop(value)) this_thread::yield();
+        return value;
+    }
+};
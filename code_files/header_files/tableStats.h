@@ -0,0 +1,50 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "flightRecorder.h"
+
+using namespace std;
+
+// Page table size counters, kept up to date as levels and arrays are
+// allocated and freed so they can be read at any time in O(1)
+struct TableStats {
+    uint64_t entries = 0; // Entries currently allocated (child pointer slots + mapping slots)
+    uint64_t bytes = 0; // Bytes currently allocated for levels and their arrays
+    uint64_t peakEntries = 0; // Highest value entries has reached
+    uint64_t peakBytes = 0; // Highest value bytes has reached
+    vector<uint64_t> nodesPerDepth; // Level nodes currently alive at each depth
+    FlightRecorder* recorder = nullptr; // gets an event per allocation / release when set
+
+    // records an allocation of the given number of entries and bytes
+    void allocated(uint64_t entryDelta, uint64_t byteDelta) {
+        if (recorder) recorder->record(FlightEventType::TableAlloc, byteDelta, (uint32_t)entryDelta);
+        entries += entryDelta;
+        bytes += byteDelta;
+        if (entries > peakEntries) peakEntries = entries;
+        if (bytes > peakBytes) peakBytes = bytes;
+    }
+
+    // records a release of the given number of entries and bytes
+    void released(uint64_t entryDelta, uint64_t byteDelta) {
+        if (recorder) recorder->record(FlightEventType::TableFree, byteDelta, (uint32_t)entryDelta);
+        entries -= entryDelta;
+        bytes -= byteDelta;
+    }
+
+    // records a Level node being created / destroyed at the given depth
+    void nodeCreated(unsigned depth, uint64_t nodeBytes) {
+        if (depth >= nodesPerDepth.size()) nodesPerDepth.resize(depth + 1, 0);
+        nodesPerDepth[depth]++;
+        allocated(0, nodeBytes);
+    }
+    void nodeDestroyed(unsigned depth, uint64_t nodeBytes) {
+        nodesPerDepth[depth]--;
+        released(0, nodeBytes);
+    }
+};
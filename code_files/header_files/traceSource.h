@@ -0,0 +1,141 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "pageTable.h"
+#include "vaddr_tracereader.h"
+
+using namespace std;
+
+// True if the record writes memory, which dirties the page it touches
+inline bool isWriteRecord(const p2AddrTr64& rec) {
+    return rec.reqtype == MEMWRITE;
+}
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Which records a TraceSource passes on (--proc, --reqtype, --addr-range).
+  Everything is accepted until a parse function below narrows it.
+
+  Procs and request types are 256-entry tables and the address test is one
+  unsigned compare, so accepts() has no branches: TraceSource runs it over
+  a whole read-ahead block at a time.
+───────────────────────────────────────────────────────────────────────────────*/
+struct TraceFilter {
+    uint8_t procOk[256]; // 1 if records of that proc are accepted
+    uint8_t typeOk[256]; // 1 if records of that reqtype are accepted
+    uint64_t addrFirst = 0; // accepted addresses: addrFirst..addrLast
+    uint64_t addrLast = UINT64_MAX;
+    bool byProc = false, byType = false, byAddr = false; // which parts are set
+
+    TraceFilter() {
+        for (int i = 0; i < 256; i++) procOk[i] = typeOk[i] = 1;
+    }
+
+    bool active() const { return byProc || byType || byAddr; }
+
+    unsigned accepts(uint64_t addr, uint8_t reqtype, uint8_t proc) const {
+        return typeOk[reqtype] & procOk[proc] & (unsigned)(addr - addrFirst <= addrLast - addrFirst);
+    }
+};
+
+// Adds the procs in "P[,P...]" (0..255) to the accepted ones. Returns false if malformed.
+bool parseProcFilter(const string& spec, TraceFilter& filter);
+
+// Adds the request types in "T[,T...]" to the accepted ones. A type is a name
+// (fetch, read, readinv, write, ioread, iowrite), data (read, readinv and
+// write: everything but fetches) or io, or a reqtype number (0x23 or 35).
+// Returns false if malformed.
+bool parseReqtypeFilter(const string& spec, TraceFilter& filter);
+
+// Keeps only addresses in [LO, HI) given as "LO:HI" in hex. Returns false if malformed.
+bool parseAddrRange(const string& spec, TraceFilter& filter);
+
+/*───────────────────────────────────────────────────────────────────────────────
+  Stream of trace records from one or more trace files.
+
+  One file is read in order. Several files (e.g. one per CPU) are merged on
+  the fly into one stream ordered by the records' time field: a k-way merge
+  over a min-heap of each file's next record, ties going to the file listed
+  first. Every file is read through its own read-ahead buffer, so the merge
+  costs a heap update per record on top of a plain sequential read.
+
+  Positions are logical byte offsets into that stream (records consumed *
+  record size), which for a single file is the file offset itself.
+
+  With a filter, rejected records are dropped from each read-ahead block
+  as soon as it is read, so they never reach the merge or the caller. The
+  stream, and so positions, counts, skip() and seek(), then only holds
+  accepted records: -n and checkpoints count what was simulated, and a
+  checkpoint has to be restored with the same filter.
+───────────────────────────────────────────────────────────────────────────────*/
+class TraceSource {
+public:
+    TraceSource() = default;
+    TraceSource(const TraceSource&) = delete;
+    TraceSource& operator=(const TraceSource&) = delete;
+    ~TraceSource() { close(); }
+
+    // Opens every path; records are p2AddrTr64 when pt uses more than 32
+    // address bits, p2AddrTr otherwise. Only records filter accepts are
+    // returned. Returns false (after printing why) if a file can't be opened.
+    bool open(const vector<string>& paths, const PageTable& pt, const TraceFilter& filter = TraceFilter());
+    void close();
+
+    // Reads the next record (32-bit records widened into a p2AddrTr64).
+    // Returns 0 at the end of the stream.
+    int next(p2AddrTr64* rec) {
+        if (inputs.size() == 1) {
+            Input& in = inputs[0];
+            if (in.pos == in.len && !refill(in)) return 0;
+            decode(in, rec);
+            consumed++;
+            return 1;
+        }
+        return nextMerged(rec);
+    }
+
+    // Skips up to count records, returns how many were skipped
+    uint64_t skip(uint64_t count);
+
+    // Moves to logical offset (a position() value) from the start of the
+    // stream. Returns false if the stream is shorter.
+    bool seek(uint64_t offset);
+
+    uint64_t position() const { return consumed * recordSize; }
+    uint64_t totalRecords(); // records in all files together (accepted ones, counted on first call, if filtered)
+    long recordBytes() const { return recordSize; } // size of one record on disk
+
+private:
+    struct Input {
+        FILE* f = nullptr;
+        vector<unsigned char> buf; // read-ahead buffer, whole records only
+        size_t pos = 0; // next unread byte in buf
+        size_t len = 0; // valid bytes in buf
+        p2AddrTr64 head{}; // next record, when the input is in the merge heap
+    };
+
+    vector<Input> inputs;
+    vector<size_t> heap; // indices into inputs, ordered by (head.time, index)
+    bool wide = false; // p2AddrTr64 records
+    TraceFilter filter;
+    bool filtering = false; // filter.active(), checked once per block
+    bool totalKnown = true; // false until a filtered total has been counted
+    long recordSize = sizeof(p2AddrTr);
+    uint64_t consumed = 0; // records returned (or skipped) so far
+    uint64_t total = 0;
+
+    bool refill(Input& in);
+    size_t filterBlock(unsigned char* block, size_t records) const; // compacts accepted records to the front
+    void decode(Input& in, p2AddrTr64* rec);
+    bool heapBefore(size_t a, size_t b) const; // true if input a's head comes first
+    void siftDown(size_t slot);
+    void buildHeap();
+    int nextMerged(p2AddrTr64* rec);
+};
@@ -0,0 +1,60 @@
+/**
+ * Author: Gilad Bitton
+ * RedID: 130621085
+ *
+ * **/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "simulation.h"
+
+using namespace std;
+
+// Deepest table -l tune considers
+static const int MAX_TUNE_DEPTH = 8;
+
+// Most level splits -l tune will simulate in one run
+static const uint64_t MAX_TUNE_CANDIDATES = 20000;
+
+// Settings for -l tune
+struct TuneOptions {
+    int maxDepth = 4; // candidates have 1..maxDepth levels
+    int threads = 1; // candidates simulated at once
+    double walkBudget = -1; // >= 0: only report splits whose average walk fits in it
+};
+
+/*───────────────────────────────────────────────────────────────────────────────
+  -l tune: searches the level splits of base's VPN bits (the sum of the
+  command line level bits, so the page size stays put) for the table that
+  needs the least memory for a given walk length.
+
+  Every split of those bits into 1..maxDepth levels of at most 30 bits is
+  a candidate. The trace is decoded once into runs of accesses to the same
+  page, which do not depend on the split; a pool of threads then takes
+  candidates one at a time and replays the runs through a Simulator of
+  its own with base's settings (frames, interval, -r, --sparse-levels,
+  prefetch, allocation) and the candidate's levels.
+
+  Each candidate is scored on its peak page table bytes, the entries
+  countEntries reports at the end, and its average walk length: table
+  levels read per access, where an access to the page of the previous one
+  reads none and a walk the page walk cache resumes skips the levels above
+  it. --pwc sizes are per depth and every candidate gets the same ones
+  (a list longer than a candidate's table is cut off), so with the cache
+  the walk depends on how well each split's upper levels cache, not only
+  on its depth. Without it a split's walk is its depth times the share of
+  accesses that walk, and the frontier has at most one split per depth.
+  Caches and latency are left out.
+
+  Prints CSV, one row per split on the Pareto frontier of (average walk,
+  peak bytes), shortest walk first: no other split has both a walk at
+  most as long and fewer peak bytes. With a walk budget only the frontier
+  within it is printed, so the last row is the smallest table that fits.
+
+  Returns 0 on success, 1 if the trace cannot be opened or there are too
+  many candidates.
+───────────────────────────────────────────────────────────────────────────────*/
+int runTune(const vector<string>& traceFiles, const SimulatorConfig& base, int64_t numAccesses,
+            const TraceFilter& filter, const TuneOptions& opts);
@@ -1,3 +1,5 @@
+#ifndef VADDR_TRACEREADER_H
+#define VADDR_TRACEREADER_H
 
 /* C and C++ define some of their types in different places.
  * Check and see if we are using C or C++ and include appropriately
@@ -22,6 +24,19 @@ typedef struct BYUADDRESSTRACE
   uint32_t time;
 } p2AddrTr;
 
+/* 64-bit variant of the BYU record for x86-64 traces (48/57-bit
+ * virtual addresses). Same fields, wider address.
+ */
+typedef struct BYUADDRESSTRACE64
+{
+  uint64_t addr;
+  unsigned char reqtype;
+  unsigned char size;
+  unsigned char attr;
+  unsigned char proc;
+  uint32_t time;
+} p2AddrTr64;
+
 typedef enum {
   UNKNOWN,
   LITTLE,	/* native format of trace file */
@@ -34,6 +49,12 @@ typedef enum {
  */
 int NextAddress(FILE *trace_file, p2AddrTr *addr_ptr);
 
+/* ConvertAddress / ConvertAddress64 - Convert a record that was read in
+ * bulk (e.g. many records per fread) from trace byte order to host order.
+ */
+void ConvertAddress(p2AddrTr *addr_ptr);
+void ConvertAddress64(p2AddrTr64 *addr_ptr);
+
 /* reqtype values */
 #define FETCH			0x00	// instruction fetch
 #define MEMREAD			0x01	// memory read
@@ -57,3 +78,4 @@ int NextAddress(FILE *trace_file, p2AddrTr *addr_ptr);
 #define SMIACK			0x37	// acknowledge SMI mode
 						
 
+#endif